@@ -4,11 +4,20 @@ lex - Lexical Analyzer for PL /0
 Author : Xavier Soto and Gregory Berzinski
 Language : C ( only )
 To Compile :
-gcc - O2 - std = c11 -o lex lex . c
+gcc - O2 - std = c11 -o lexgen lexgen . c && ./ lexgen > lextab . h
+gcc - O2 - std = c11 - pthread -o lex lex . c
+(lextab . h is checked in; regenerate it after changing lexspec . h)
 To Execute ( on Eustis ):
-./ lex < input file >
+./ lex [-g] [-b] [-j <threads>] < input file >
 where :
 < input file > is the path to the PL /0 source program
+-g also writes tokens.pos (line and column of every token)
+-b writes the token list to tokens.bin in binary (see pm0tokens.h)
+   instead of printing it; read it with ./parsercodegen -b
+-j scans the source in chunks on up to <threads> threads; the token
+   list is the same as a sequential scan's
+--stats (or --stats-json) prints the wall time of reading, scanning and
+   writing, with byte and token counts, to stderr
 Notes :
 - Implement a lexical analyser for the PL /0 language .
 - The program must detect errors such as
@@ -23,55 +32,18 @@ Due Date : Friday , October 3 , 2025 at 11:59 PM ET
 */
 
 
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-
-//Token Type Enumeration in C
-typedef enum {
-    errorsym = 0, //holds the invalid to print
-    skipsym = 1 , // Skip / ignore token
-    identsym , // Identifier
-    numbersym , // Number
-    plussym , // +
-    minussym , // -
-    multsym , // *
-    slashsym , // /
-    eqsym , // =
-    neqsym , // <>
-    lessym , // <
-    leqsym , // <=
-    gtrsym , // >
-    geqsym , // >=
-    lparentsym , // (
-    rparentsym , // )
-    commasym , // ,
-    semicolonsym , // ;
-    periodsym , // .
-    becomessym , // :=
-    beginsym , // begin
-    endsym , // end
-    ifsym , // if
-    fisym , // fi
-    thensym , // then
-    whilesym , // while
-    dosym , // do
-    callsym , // call
-    constsym , // const
-    varsym , // var
-    procsym , // procedure
-    writesym , // write
-    readsym , // read
-    elsesym , // else
-    evensym, // even
-} TokenType ;
-
-//Global Table / Reserved Words
-const char *reservedWords[] = {
-    "begin","end","if","fi","then","while","do","call",
-    "const","var","procedure","write","read","else","even"
-};
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "pm0tokens.h"
+//Token grammar and the scanner tables generated from it (./lexgen > lextab.h)
+#include "lexspec.h"
+#include "lextab.h"
 
 //error messages
 const char *errorMessage[] = {
@@ -80,42 +52,86 @@ const char *errorMessage[] = {
 };
 
 
-//Global Reservedtokens
-const TokenType reservedTokens[] = {
-    beginsym, endsym, ifsym, fisym, thensym, whilesym, dosym, callsym,
-    constsym, varsym, procsym, writesym, readsym, elsesym, evensym,
-};
-
-//global variables
-#define MAX_IDENT_LENGTH 11 //Identifier must be max 11 words
-#define MAX_NUM_LENGTH 5 //Variable must not exceed the Then Thousand mark (5 Digits)
-
-
-//Struct for saving each token
+//Struct for saving each token; its lexeme is source[start .. start + len)
 typedef struct {
     TokenType type;
-    char lexeme[64];   // for identifier or number string
     int errors;
+    size_t start;      // offset of the lexeme in the source buffer
+    int len;           // lexeme length (at most 63)
+    int line, col;     // source position of the first character (1-based)
 } Token;
 
+//Growable array of tokens
+typedef struct {
+    Token *tokens;
+    int count, cap;
+} TokenList;
+
+//Scanner over one part of the source buffer (the whole file, or one chunk with -j)
+typedef struct {
+    size_t pos, end;   // next character and the end of the part
+    int line;          // current source line
+    size_t lineStart;  // offset of its first character
+    int inComment;     // the part starts inside a /* ... */ comment not yet closed
+} Scanner;
+
+//The whole source file, read into memory
+const unsigned char *source;
+size_t sourceSize;
+
+//Parallel scanning (-j): chunks are at least this large
+#define MIN_CHUNK (1 << 20)
+#define MAX_THREADS 64
+int chunksUsed = 1;
+
+//Scanner statistics (--stats, --stats-json): wall time and bytes of each phase
+#define STATS_TEXT 1
+#define STATS_JSON 2
+int statsFormat = 0;
+long scanErrors = 0;   // errorsym tokens, counted before the token list turns them into skipsym
+enum { PH_READ, PH_SCAN, PH_POSITIONS, PH_OUTPUT, PH_COUNT };
+struct {
+    const char *name;
+    int runs;
+    double wall;    // seconds
+    long bytes;     // bytes read or written, -1 if unknown
+} phases[PH_COUNT] = {
+    {"read", 0, 0, -1}, {"scan", 0, 0, -1}, {"positions", 0, 0, -1}, {"output", 0, 0, -1},
+};
+
 //Functions
-int isReservedWord(const char *word);
-Token getNextToken(FILE *fp);
+Token getNextToken(Scanner *s);
+void scanPart(Scanner *s, TokenList *list);
+void scanParallel(int threads, TokenList *list);
 void printSource(FILE *fp);
 void printLexemeTable(Token tokens[], int count);
 void printTokenList(Token tokens[], int count);
+void writeTokenPositions(Token tokens[], int count);
+void writeTokenBinary(Token tokens[], int count);
+double wallNow(void);
+void phaseDone(int id, double start);
+void reportStats(TokenList *list);
 
 //Main
 int main(int argc, char *argv[]) {
 
     //Checks for proper arguments when running in terminal
-    if (argc != 2) {
-        printf("Usage: ./lex <input file>\n");
+    int positions = 0, binary = 0, threads = 1, argi = 1;
+    for (; argi < argc - 1; argi++) {
+        if (strcmp(argv[argi], "-g") == 0) positions = 1;
+        else if (strcmp(argv[argi], "-b") == 0) binary = 1;
+        else if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc - 1) threads = atoi(argv[++argi]);
+        else if (strcmp(argv[argi], "--stats") == 0) statsFormat = STATS_TEXT;
+        else if (strcmp(argv[argi], "--stats-json") == 0) statsFormat = STATS_JSON;
+        else break;
+    }
+    if (argi != argc - 1 || threads < 1 || threads > MAX_THREADS) {
+        printf("Usage: ./lex [-g] [-b] [-j <threads>] [--stats|--stats-json] <input file>\n");
         return 1;
     }
 
     //Reading file.txt
-    FILE *fp = fopen(argv[1], "r");
+    FILE *fp = fopen(argv[argc - 1], "rb");
 
     //Check if file exists.
     if (!fp) {
@@ -129,239 +145,266 @@ int main(int argc, char *argv[]) {
     //printf("Source Program:\n\n");
     //printSource(fp);
 
-    // rewind file to scan again
-    rewind(fp);
-
-    //Tokenize
-    Token tokens[1000]; //Array to store tokens
-    int count = 0;
-
-    //Loop to start getting tokens
-    Token t;
-    while (1) {
-        t = getNextToken(fp);
-        
-        // Stop if EOF reached
-        if (feof(fp) && t.type == skipsym && strlen(t.lexeme) == 0) break;
+    //Read the whole source into memory, so it can be scanned in chunks
+    double start = wallNow();
+    size_t cap = 1 << 16;
+    unsigned char *buf = malloc(cap);
+    sourceSize = 0;
+    while (buf) {
+        sourceSize += fread(buf + sourceSize, 1, cap - sourceSize, fp);
+        if (sourceSize < cap) break;
+        cap *= 2;
+        buf = realloc(buf, cap);
+    }
+    if (!buf || ferror(fp)) {
+        perror("read");
+        return 1;
+    }
+    source = buf;
 
-        // skip whitespace/comments
-        if (t.type == skipsym) continue; 
+    //Close File 
+    fclose(fp);
+    phases[PH_READ].bytes = (long)sourceSize;
+    phaseDone(PH_READ, start);
 
-        // nothing valid
-        if (strlen(t.lexeme) == 0) continue; 
-        
-        //Save the Token to array of tokens 
-        tokens[count++] = t;
+    //Tokenize
+    start = wallNow();
+    TokenList list = {NULL, 0, 0};
+    if (threads > 1 && sourceSize >= 2 * (size_t)MIN_CHUNK) {
+        scanParallel(threads, &list);
+    } else {
+        Scanner s = {0, sourceSize, 1, 0, 0};
+        scanPart(&s, &list);
+    }
+    phaseDone(PH_SCAN, start);
+    for (int i = 0; statsFormat && i < list.count; i++) {
+        if (list.tokens[i].type == errorsym) scanErrors++;
     }
 
     //Call Function to Print Lexeme Table
-    //printLexemeTable(tokens, count);
+    //printLexemeTable(list.tokens, list.count);
 
-    //Call Function to print the Token List
-    printTokenList(tokens, count);
+    //Token positions for the parser's debug info (-g)
+    start = wallNow();
+    if (positions) writeTokenPositions(list.tokens, list.count), phaseDone(PH_POSITIONS, start);
 
+    //Call Function to print the Token List, or write it in binary (-b)
+    start = wallNow();
+    if (binary) writeTokenBinary(list.tokens, list.count);
+    else printTokenList(list.tokens, list.count);
+    fflush(stdout);
+    phaseDone(PH_OUTPUT, start);
 
-    //Close File 
-    fclose(fp);
+    if (statsFormat) reportStats(&list);
     return 0;
 }
 
-//Function that takes in the word and checks if its reserved
-int isReservedWord(const char *word) {
-
-    //Loops through the global array of reserved words 
-    for (int i = 0; i < sizeof(reservedWords)/sizeof(reservedWords[0]); i++) {
-
-        //Checks if word is used
-        if (strcmp(word, reservedWords[i]) == 0) {
-
-            //IF reserved, return its token
-            return reservedTokens[i];  
+//Function that reserves room for one more token
+Token *newToken(TokenList *list) {
+    if (list->count == list->cap) {
+        list->cap = list->cap ? 2 * list->cap : 1024;
+        list->tokens = realloc(list->tokens, list->cap * sizeof(Token));
+        if (!list->tokens) {
+            perror("realloc");
+            exit(1);
         }
     }
-
-    //return -1 as word not reserved
-    return -1; 
+    return &list->tokens[list->count++];
 }
 
-//Function that classifies each input as token
-Token getNextToken(FILE *fp) {
+//Function that reads the next token by running the generated DFA (lextab.h): one
+//class lookup and one table lookup per byte, until a transition ends the token
+Token getNextToken(Scanner *s) {
 
     //Initialize variables
     Token t;
-    int c;
+    size_t pos = s->pos, end = s->end, lineStart = s->lineStart;
+    int line = s->line;
 
-    //Skip whitespace and comments
-    while ((c = fgetc(fp)) != EOF) {
-        if (isspace(c)) continue;  // skip spaces, tabs, newlines
-
-        // Comment handling: /* ... */
-        if (c == '/') {
-            int next = fgetc(fp);
-            if (next == '*') {
-                int prev = 0;
-                while ((c = fgetc(fp)) != EOF) {
-                    if (prev == '*' && c == '/') break; // end of comment
-                    prev = c;
-                }
-                // Check if comment was closed before EOF
-                if (c == EOF) {
-                    // Unclosed comment detected
-                    t.type = errorsym;
-                    strcpy(t.lexeme, "/*");
-                    t.errors = 3; // Unclosed comment
-                    return t;
-                }
-                continue; // back to outer loop
-            } else {
-                if (next != EOF) ungetc(next, fp); // not a comment
-                t.type = slashsym;
-                strcpy(t.lexeme, "/");
-                return t;
-            }
+    //A part that starts inside a comment first skips the rest of it
+    int state = s->inComment ? LEX_COMMENT : LEX_START;
+    t.start = SIZE_MAX;
+    t.line = line;
+    t.col = 0;
+
+    while (1) {
+        //Whitespace and comments before the token are skipped
+        if (state == LEX_START) {
+            t.start = pos;
+            t.line = line;
+            t.col = (int)(pos - lineStart) + 1;
+        }
+        if (pos == end) break;
+        int c = source[pos];
+        int next = lexNext[state][lexClass[c]];
+        if (!next) break;
+        if (c == '\n') {
+            line++;
+            lineStart = pos + 1;
         }
-        break; // found non-whitespace, non-comment
+        pos++;
+        state = next;
     }
+    s->pos = pos;
+    s->line = line;
+    s->lineStart = lineStart;
 
-    // End of file
-    if (c == EOF) {
+    //The part ended inside the comment it started in
+    if (t.start == SIZE_MAX) {
         t.type = skipsym;
-        strcpy(t.lexeme, "");
+        t.len = 0;
         return t;
     }
+    s->inComment = 0;
 
-    //Identifiers or Reserved Words
-    if (isalpha(c)) {
-        char buffer[64];
-        int len = 0;
-        buffer[len++] = c;
-
-        while ((c = fgetc(fp)) != EOF && isalnum(c) && len < 63) {
-            buffer[len++] = c;
-        }
-
-        //account for null
-        buffer[len] = '\0';
-        if (c != EOF) ungetc(c, fp);
+    //Token of the state the DFA stopped in
+    t.type = lexAccept[state].type;
+    t.errors = lexAccept[state].errors;
+    t.len = lexAccept[state].len ? lexAccept[state].len : (int)(pos - t.start);
+    return t;
+}
 
-        //see if its reserved word
-        int reserved = isReservedWord(buffer);
+//Function that scans one part of the source into a token list
+void scanPart(Scanner *s, TokenList *list) {
+    Token t;
+    while ((t = getNextToken(s)).type != skipsym) {
+        // A NUL byte reads as an empty lexeme and is dropped
+        if (source[t.start] == '\0') continue;
 
-        //Check if its reserved
-        if (reserved != -1) {
-            t.type = reserved;
-        } else {
-            if (len > MAX_IDENT_LENGTH) {
-                t.type = errorsym;
-                strcpy(t.lexeme, buffer);
-                t.errors = 0;
-                return t;
-            }
-            t.type = identsym;
-        }
-        strcpy(t.lexeme, buffer);
-        return t;
+        //Save the Token to the list
+        *newToken(list) = t;
     }
+}
 
-    //Numbers
-    if (isdigit(c)) {
-        char buffer[64];
-        int len = 0;
-        buffer[len++] = c;
+//One chunk of the source for parallel scanning (-j)
+typedef struct {
+    size_t begin, end;    // chunk is source[begin .. end); begin follows a whitespace character
+    int endState[2];      // comment state at end for each start state (0 outside, 1 inside)
+    int newlines;         // newlines in the chunk
+    long lastNewline;     // offset of the last one, -1 if none
+    Scanner s;
+    TokenList list;
+} Chunk;
+
+//States of the comment pre-pass: outside, outside after '/', inside, inside after '*'
+enum { CM_OUT, CM_SLASH, CM_IN, CM_STAR };
+
+//Function that advances the comment pre-pass by one character, as getNextToken would
+static inline int commentStep(int state, int c) {
+    switch (state) {
+        case CM_OUT:   return c == '/' ? CM_SLASH : CM_OUT;
+        case CM_SLASH: return c == '*' ? CM_IN : (c == '/' ? CM_SLASH : CM_OUT);
+        case CM_IN:    return c == '*' ? CM_STAR : CM_IN;
+        default:       return c == '/' ? CM_OUT : (c == '*' ? CM_STAR : CM_IN);
+    }
+}
 
-        while ((c = fgetc(fp)) != EOF && isdigit(c) && len < 63) {
-             buffer[len++] = c;
+//Thread: comment state at the end of the chunk for both start states, and its newlines.
+//A chunk starts after whitespace, so it starts either outside or plainly inside a comment.
+void *prepassChunk(void *arg) {
+    Chunk *ch = arg;
+    int a = CM_OUT, b = CM_IN;
+    ch->newlines = 0;
+    ch->lastNewline = -1;
+    for (size_t p = ch->begin; p < ch->end; p++) {
+        int c = source[p];
+        if (c == '\n') {
+            ch->newlines++;
+            ch->lastNewline = (long)p;
         }
+        int same = (a == b); // once the two agree they stay together
+        a = commentStep(a, c);
+        b = same ? a : commentStep(b, c);
+    }
+    ch->endState[0] = (a == CM_IN || a == CM_STAR);
+    ch->endState[1] = (b == CM_IN || b == CM_STAR);
+    return NULL;
+}
 
-        //save null
-        buffer[len] = '\0';
-        if (c != EOF) ungetc(c, fp);
+//Thread: scan one chunk from its resolved state
+void *scanChunk(void *arg) {
+    Chunk *ch = arg;
+    scanPart(&ch->s, &ch->list);
+    return NULL;
+}
 
-        //check if its valid
-        if (len > MAX_NUM_LENGTH) {
-            t.type = errorsym;
-            strcpy(t.lexeme, buffer);
-            t.errors = 1;
-        } else {
-            t.type = numbersym;
-            strcpy(t.lexeme, buffer);
+//Function that scans the source in chunks on several threads. Chunk boundaries are
+//moved to just after a whitespace character, so no token spans one. A parallel
+//pre-pass finds each chunk's comment state and newline count for either start
+//state; chaining them gives the exact state and position at every boundary. The
+//chunk token lists are then joined in order, with an unclosed comment reported once.
+void scanParallel(int threads, TokenList *list) {
+    Chunk chunks[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    int n = 0;
+    if ((size_t)threads > sourceSize / MIN_CHUNK) threads = (int)(sourceSize / MIN_CHUNK);
+
+    //Boundaries
+    size_t begin = 0;
+    for (int i = 1; i <= threads && begin < sourceSize; i++) {
+        size_t end = sourceSize;
+        if (i < threads) {
+            end = sourceSize / threads * i;
+            if (end < begin) end = begin;
+            while (end < sourceSize && !isspace(source[end])) end++;
+            if (end < sourceSize) end++;
         }
-        return t;
+        memset(&chunks[n], 0, sizeof(Chunk));
+        chunks[n].begin = begin;
+        chunks[n].end = end;
+        begin = end;
+        n++;
     }
 
-    //Handle Special Symbols
-    switch (c) {
-        case '+': t.type = plussym; strcpy(t.lexeme, "+"); return t; //+
-        case '-': t.type = minussym; strcpy(t.lexeme, "-"); return t; //-
-        case '*': t.type = multsym; strcpy(t.lexeme, "*"); return t; //*
-        case '=': t.type = eqsym; strcpy(t.lexeme, "="); return t; // =
-        case ',': t.type = commasym; strcpy(t.lexeme, ","); return t; // ,
-        case ';': t.type = semicolonsym; strcpy(t.lexeme, ";"); return t; // ;
-        case '.': t.type = periodsym; strcpy(t.lexeme, "."); return t; // .
-        case '(': t.type = lparentsym; strcpy(t.lexeme, "("); return t; // ()
-        case ')': t.type = rparentsym; strcpy(t.lexeme, ")"); return t; // )
-
-        //Check for :=
-        //First start with : 
-        //Then Check the =
-        case ':': {
-            int next = fgetc(fp);
-            if (next == '=') {
-                t.type = becomessym;
-                strcpy(t.lexeme, ":=");
-            } else {
-                if (next != EOF) ungetc(next, fp);
-                t.type = errorsym;
-                t.lexeme[0] = ':';    // save the offending character
-                t.lexeme[1] = '\0';
-                t.errors = 2; 
-            }
-            return t;
-        }
-
-        //Account for <= , <> , or simply <
-        case '<': {
-
-            int next = fgetc(fp);
-
-            if (next == '=') {
-                t.type = leqsym; strcpy(t.lexeme, "<=");
-            } else if (next == '>') {
-                t.type = neqsym; strcpy(t.lexeme, "<>");
-            } else {
-                if (next != EOF) ungetc(next, fp);
-                t.type = lessym; strcpy(t.lexeme, "<");
-            }
-            return t;
-        }
+    chunksUsed = n;
+
+    //Pre-pass
+    for (int i = 0; i < n; i++) pthread_create(&tid[i], NULL, prepassChunk, &chunks[i]);
+    for (int i = 0; i < n; i++) pthread_join(tid[i], NULL);
+
+    //Chain the states and positions
+    int inComment = 0, line = 1;
+    long lastNewline = -1;
+    for (int i = 0; i < n; i++) {
+        Scanner s = {chunks[i].begin, chunks[i].end, line, (size_t)(lastNewline + 1), inComment};
+        chunks[i].s = s;
+        inComment = chunks[i].endState[inComment];
+        line += chunks[i].newlines;
+        if (chunks[i].lastNewline >= 0) lastNewline = chunks[i].lastNewline;
+    }
 
-        //Account for >= or simply <
-        case '>': {
-            int next = fgetc(fp);
-
-            if (next == '=') {
-                t.type = geqsym; strcpy(t.lexeme, ">=");
-            } else {
-                if (next != EOF) ungetc(next, fp);
-                t.type = gtrsym; strcpy(t.lexeme, ">");
-            }
-            return t;
+    //Scan
+    for (int i = 0; i < n; i++) pthread_create(&tid[i], NULL, scanChunk, &chunks[i]);
+    for (int i = 0; i < n; i++) pthread_join(tid[i], NULL);
+
+    //Join: a chunk ending in an unclosed comment reports it only if no later chunk closes it
+    int total = 1;
+    for (int i = 0; i < n; i++) total += chunks[i].list.count;
+    list->tokens = malloc(total * sizeof(Token));
+    list->cap = total;
+    if (!list->tokens) {
+        perror("malloc");
+        exit(1);
+    }
+    Token unclosed;
+    int pending = 0;
+    for (int i = 0; i < n; i++) {
+        TokenList *part = &chunks[i].list;
+        if (pending && !chunks[i].s.inComment) pending = 0; // closed in this chunk
+        int keep = part->count;
+        Token *last = keep > 0 ? &part->tokens[keep - 1] : NULL;
+        if (i < n - 1 && last && last->type == errorsym && last->errors == 3) {
+            unclosed = *last;
+            pending = 1;
+            keep--;
         }
+        if (keep > 0) memcpy(list->tokens + list->count, part->tokens, keep * sizeof(Token));
+        list->count += keep;
+        free(part->tokens);
     }
-
-    //Invalid symbol
-    // Invalid symbol (anything else not matched above)
-    t.type = errorsym;
-    t.lexeme[0] = (char)c;   // save the actual bad character
-    t.lexeme[1] = '\0';      // null terminator
-    t.errors = 2;            //Invalid Symbol
-
-return t;
-
+    if (pending) list->tokens[list->count++] = unclosed;
 }
 
-
-
 //function to print the File Source Program
 void printSource(FILE *fp) {
     int c;
@@ -411,7 +454,7 @@ void printTokenList(Token tokens[], int count) {
         //If var or identifier, print it
         if(((tokens[i].type == 2) || (tokens[i].type == 3)) && !(tokens[i].type == errorsym)){
 
-            printf("%s ", tokens[i].lexeme);
+            printf("%.*s ", tokens[i].len, (const char *)source + tokens[i].start);
         }
 
     
@@ -419,4 +462,104 @@ void printTokenList(Token tokens[], int count) {
 
     }
     printf("\n");
-}
\ No newline at end of file
+}
+
+//Function that writes tokens.pos: "line column" for each token, in token list order
+void writeTokenPositions(Token tokens[], int count) {
+    FILE *f = fopen("tokens.pos", "w");
+    if (!f) {
+        perror("tokens.pos");
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        fprintf(f, "%d %d\n", tokens[i].line, tokens[i].col);
+    }
+    phases[PH_POSITIONS].bytes = ftell(f);
+    fclose(f);
+}
+
+//Function that writes tokens.bin: the header, the type and value arrays and the
+//string table, built in one buffer and written with a single fwrite
+void writeTokenBinary(Token tokens[], int count) {
+    size_t strBytes = 0;
+    for (int i = 0; i < count; i++) {
+        if (tokens[i].type == identsym) strBytes += tokens[i].len + 1;
+    }
+    size_t size = sizeof(pm0tokens_header) + 2 * (size_t)count * sizeof(int32_t) + strBytes;
+    char *buf = malloc(size);
+    if (!buf) {
+        perror("malloc");
+        exit(1);
+    }
+    pm0tokens_header *h = (pm0tokens_header *)buf;
+    int32_t *type = (int32_t *)(buf + sizeof(*h));
+    int32_t *value = type + count;
+    char *strings = (char *)(value + count);
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, PM0TOKENS_MAGIC, sizeof(h->magic));
+    h->version = PM0TOKENS_VERSION;
+    h->count = count;
+    h->strBytes = (int32_t)strBytes;
+
+    size_t at = 0;
+    for (int i = 0; i < count; i++) {
+        //Errors become skipsym, as in the text token list
+        type[i] = (tokens[i].type == errorsym) ? skipsym : tokens[i].type;
+        value[i] = 0;
+        if (tokens[i].type == numbersym) {
+            for (int k = 0; k < tokens[i].len; k++) value[i] = 10 * value[i] + (source[tokens[i].start + k] - '0');
+        } else if (tokens[i].type == identsym) {
+            value[i] = (int32_t)at;
+            memcpy(strings + at, source + tokens[i].start, tokens[i].len);
+            at += tokens[i].len;
+            strings[at++] = '\0';
+        }
+    }
+
+    FILE *f = fopen("tokens.bin", "wb");
+    if (!f || fwrite(buf, 1, size, f) != size || fclose(f) != 0) {
+        perror("tokens.bin");
+        exit(1);
+    }
+    phases[PH_OUTPUT].bytes = (long)size;
+    free(buf);
+}
+
+//Function that reads the wall clock in seconds
+double wallNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//Function that charges the time since start to a phase
+void phaseDone(int id, double start) {
+    phases[id].wall += wallNow() - start;
+    phases[id].runs++;
+}
+
+//Function that reports each phase's wall time and counters on stderr (--stats, --stats-json)
+void reportStats(TokenList *list) {
+    int json = (statsFormat == STATS_JSON), rows = 0;
+    double total = 0;
+    if (json) fprintf(stderr, "{\"tool\": \"lex\", \"phases\": [");
+    else fprintf(stderr, "Phase           Runs   Wall (ms) Counters\n");
+    for (int i = 0; i < PH_COUNT; i++) {
+        if (!phases[i].runs) continue;
+        total += phases[i].wall;
+        if (json) {
+            fprintf(stderr, "%s{\"name\": \"%s\", \"runs\": %d, \"wall_ms\": %.3f", rows ? ", " : "", phases[i].name, phases[i].runs, phases[i].wall * 1000);
+            if (phases[i].bytes >= 0) fprintf(stderr, ", \"bytes\": %ld", phases[i].bytes);
+            if (i == PH_SCAN) fprintf(stderr, ", \"tokens\": %d, \"errors\": %ld, \"chunks\": %d", list->count, scanErrors, chunksUsed);
+            fprintf(stderr, "}");
+        } else {
+            fprintf(stderr, "%-14s %5d %11.3f", phases[i].name, phases[i].runs, phases[i].wall * 1000);
+            if (phases[i].bytes >= 0) fprintf(stderr, " bytes=%ld", phases[i].bytes);
+            if (i == PH_SCAN) fprintf(stderr, " tokens=%d errors=%ld chunks=%d", list->count, scanErrors, chunksUsed);
+            fprintf(stderr, "\n");
+        }
+        rows++;
+    }
+    if (json) fprintf(stderr, "], \"total_ms\": %.3f}\n", total * 1000);
+    else fprintf(stderr, "%-14s %5s %11.3f\n", "total", "", total * 1000);
+}
@@ -0,0 +1,186 @@
+/*
+lexgen - Scanner table generator for PL/0
+Builds the DFA for the token grammar in lexspec.h and prints it as lextab.h,
+the tables lex.c's getNextToken() runs on.
+Language : C ( only )
+To Compile :
+gcc -O2 -std=c11 -o lexgen lexgen.c
+To Execute :
+./lexgen > lextab.h
+Notes :
+- State 0 is the dead state: a transition to it ends the token before the
+  character. Every other state has an accept action, the token it produces
+  when it ends there (or at the end of the input).
+- Identifier and number states count their length up to MAX_LEXEME, so the
+  length limits and the split of long lexemes are states too.
+- Reserved words and operators are tries on top of the identifier and
+  start states.
+- Bytes that every state treats alike share a character class, which keeps
+  the table dense.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#define LEXSPEC_TABLES
+#include "lexspec.h"
+
+#define MAX_STATES 255
+#define FIXED_COUNT (int)(sizeof(fixedTokens) / sizeof(fixedTokens[0]))
+
+//Transition rows over all 256 bytes, accept actions and names of the states
+int next[MAX_STATES][256];
+struct {
+    int type, errors, len;
+} accept[MAX_STATES];
+char names[MAX_STATES][32];
+int stateCount = 0;
+
+//States of a fixed-token trie, by prefix
+char prefixes[MAX_STATES][16];
+int prefixState[MAX_STATES];
+int prefixCount = 0;
+
+//Function that adds a state with no transitions
+int newState(const char *name, int type, int errors, int len) {
+    if (stateCount == MAX_STATES) {
+        fprintf(stderr, "lexgen: more than %d states\n", MAX_STATES);
+        exit(1);
+    }
+    int s = stateCount++;
+    memset(next[s], 0, sizeof(next[s]));
+    accept[s].type = type;
+    accept[s].errors = errors;
+    accept[s].len = len;
+    snprintf(names[s], sizeof(names[s]), "%s", name);
+    return s;
+}
+
+//Function that finds the fixed token whose text is exactly text, -1 if none
+int fixedToken(const char *text, int len) {
+    for (int i = 0; i < FIXED_COUNT; i++) {
+        if ((int)strlen(fixedTokens[i].text) == len && strncmp(fixedTokens[i].text, text, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//Function that finds the trie state of a prefix, -1 if it has none yet
+int findPrefix(const char *text, int len) {
+    for (int i = 0; i < prefixCount; i++) {
+        if ((int)strlen(prefixes[i]) == len && strncmp(prefixes[i], text, len) == 0) return prefixState[i];
+    }
+    return -1;
+}
+
+int main(void) {
+    int idState[MAX_LEXEME + 1], numState[MAX_LEXEME + 1];
+    char name[32];
+
+    //Dead and start states; reaching the end of the input in the start state ends the token list
+    newState("DEAD", errorsym, 0, 0);
+    int start = newState("START", skipsym, 0, 0);
+    int invalid = newState("INVALID", errorsym, ERR_INVALID_SYMBOL, 0);
+
+    //Identifiers and numbers, counting their length
+    for (int k = 1; k <= MAX_LEXEME; k++) {
+        snprintf(name, sizeof(name), "IDENT_%d", k);
+        idState[k] = (k <= MAX_IDENT_LENGTH) ? newState(name, identsym, 0, 0) : newState(name, errorsym, ERR_IDENT_LENGTH, 0);
+        snprintf(name, sizeof(name), "NUMBER_%d", k);
+        numState[k] = (k <= MAX_NUM_LENGTH) ? newState(name, numbersym, 0, 0) : newState(name, errorsym, ERR_NUM_LENGTH, 0);
+    }
+    for (int k = 1; k < MAX_LEXEME; k++) {
+        for (int c = 0; c < 256; c++) {
+            if (isalnum(c)) next[idState[k]][c] = idState[k + 1];
+            if (isdigit(c)) next[numState[k]][c] = numState[k + 1];
+        }
+    }
+
+    //Start state: whitespace is skipped, any other byte starts a token
+    for (int c = 0; c < 256; c++) {
+        if (isspace(c)) next[start][c] = start;
+        else if (isalpha(c)) next[start][c] = idState[1];
+        else if (isdigit(c)) next[start][c] = numState[1];
+        else next[start][c] = invalid;
+    }
+
+    //Fixed tokens: one trie state per prefix, linked from the start state
+    for (int i = 0; i < FIXED_COUNT; i++) {
+        const char *text = fixedTokens[i].text;
+        int word = isalpha((unsigned char)text[0]);
+        int from = start;
+        for (int len = 1; text[len - 1]; len++) {
+            int s = findPrefix(text, len);
+            if (s < 0) {
+                int exact = fixedToken(text, len);
+                snprintf(name, sizeof(name), "\"%.*s\"", len, text);
+                if (exact >= 0) s = newState(name, fixedTokens[exact].type, 0, 0);
+                else if (word) s = newState(name, identsym, 0, 0);
+                else if (len == 1) s = newState(name, errorsym, ERR_INVALID_SYMBOL, 0);
+                else {
+                    fprintf(stderr, "lexgen: prefix \"%.*s\" of \"%s\" is not a token\n", len, text, text);
+                    return 1;
+                }
+                //A reserved word prefix continues as an identifier of its length
+                if (word) memcpy(next[s], next[idState[len]], sizeof(next[s]));
+                snprintf(prefixes[prefixCount], sizeof(prefixes[0]), "%.*s", len, text);
+                prefixState[prefixCount++] = s;
+            }
+            next[from][(unsigned char)text[len - 1]] = s;
+            from = s;
+        }
+    }
+
+    //Comments: "/*" up to the next "*/", reported as unclosed (lexeme "/*") at the end of the input
+    int comment = newState("COMMENT", errorsym, ERR_UNCLOSED_COMMENT, 2);
+    int star = newState("COMMENT_STAR", errorsym, ERR_UNCLOSED_COMMENT, 2);
+    int slash = findPrefix("/", 1);
+    if (slash < 0) {
+        fprintf(stderr, "lexgen: no \"/\" token\n");
+        return 1;
+    }
+    next[slash]['*'] = comment;
+    for (int c = 0; c < 256; c++) {
+        next[comment][c] = (c == '*') ? star : comment;
+        next[star][c] = (c == '*') ? star : (c == '/' ? start : comment);
+    }
+
+    //Character classes: bytes with the same column in every state
+    int classOf[256], classRep[256], classCount = 0;
+    for (int c = 0; c < 256; c++) {
+        classOf[c] = -1;
+        for (int k = 0; k < classCount && classOf[c] < 0; k++) {
+            int same = 1;
+            for (int s = 0; s < stateCount && same; s++) same = (next[s][c] == next[s][classRep[k]]);
+            if (same) classOf[c] = k;
+        }
+        if (classOf[c] < 0) {
+            classRep[classCount] = c;
+            classOf[c] = classCount++;
+        }
+    }
+
+    //Print lextab.h
+    printf("/*\nGenerated by lexgen.c from lexspec.h; do not edit.\n");
+    printf("%d states, %d character classes.\n*/\n", stateCount, classCount);
+    printf("#ifndef LEXTAB_H\n#define LEXTAB_H\n");
+    printf("#define LEX_STATES %d\n#define LEX_CLASSES %d\n", stateCount, classCount);
+    printf("#define LEX_START %d\n#define LEX_COMMENT %d\n\n", start, comment);
+    printf("//Character class of each byte\nstatic const unsigned char lexClass[256] = {");
+    for (int c = 0; c < 256; c++) printf("%s%d,", (c % 16) ? " " : "\n    ", classOf[c]);
+    printf("\n};\n\n//Next state by state and character class; 0 ends the token\n");
+    printf("static const unsigned char lexNext[LEX_STATES][LEX_CLASSES] = {\n");
+    for (int s = 0; s < stateCount; s++) {
+        printf("    {");
+        for (int k = 0; k < classCount; k++) printf("%s%d", k ? "," : "", next[s][classRep[k]]);
+        printf("}, // %d %s\n", s, names[s]);
+    }
+    printf("};\n\n//Token produced when a state ends: type, error code, lexeme length (0: all characters read)\n");
+    printf("static const struct {\n    unsigned char type, errors, len;\n} lexAccept[LEX_STATES] = {\n");
+    for (int s = 0; s < stateCount; s++) {
+        printf("    {%d, %d, %d}, // %d %s\n", accept[s].type, accept[s].errors, accept[s].len, s, names[s]);
+    }
+    printf("};\n#endif\n");
+    return 0;
+}
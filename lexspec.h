@@ -0,0 +1,80 @@
+/*
+Token grammar of the PL/0 scanner, shared by lex.c and lexgen.c.
+lexgen turns it into the transition table in lextab.h:
+  gcc -O2 -std=c11 -o lexgen lexgen.c && ./lexgen > lextab.h
+Identifiers are a letter followed by letters and digits, numbers are
+digits, and both are cut into pieces of at most MAX_LEXEME characters.
+Whitespace and comments (from slash-star to the next star-slash) separate
+tokens.
+Everything else is in fixedTokens. A prefix of a fixed token that is not a
+token itself (":") is an Invalid Symbol, so such prefixes must be one
+character long. lex -j's comment pre-pass assumes '/' and '*' appear in no
+operator other than "/" and "*".
+*/
+#ifndef LEXSPEC_H
+#define LEXSPEC_H
+
+//Token Type Enumeration in C
+typedef enum {
+    errorsym = 0, //holds the invalid to print
+    skipsym = 1 , // Skip / ignore token
+    identsym , // Identifier
+    numbersym , // Number
+    plussym , // +
+    minussym , // -
+    multsym , // *
+    slashsym , // /
+    eqsym , // =
+    neqsym , // <>
+    lessym , // <
+    leqsym , // <=
+    gtrsym , // >
+    geqsym , // >=
+    lparentsym , // (
+    rparentsym , // )
+    commasym , // ,
+    semicolonsym , // ;
+    periodsym , // .
+    becomessym , // :=
+    beginsym , // begin
+    endsym , // end
+    ifsym , // if
+    fisym , // fi
+    thensym , // then
+    whilesym , // while
+    dosym , // do
+    callsym , // call
+    constsym , // const
+    varsym , // var
+    procsym , // procedure
+    writesym , // write
+    readsym , // read
+    elsesym , // else
+    evensym, // even
+} TokenType ;
+
+//Error codes of errorsym tokens, indexes into lex.c's errorMessage
+enum { ERR_IDENT_LENGTH, ERR_NUM_LENGTH, ERR_INVALID_SYMBOL, ERR_UNCLOSED_COMMENT };
+
+#define MAX_IDENT_LENGTH 11 //Identifier must be max 11 words
+#define MAX_NUM_LENGTH 5 //Variable must not exceed the Then Thousand mark (5 Digits)
+#define MAX_LEXEME 63 //Longer identifiers and numbers are split into pieces of this size
+
+#ifdef LEXSPEC_TABLES
+//Operators, punctuation and reserved words
+static const struct {
+    const char *text;
+    TokenType type;
+} fixedTokens[] = {
+    {"+", plussym}, {"-", minussym}, {"*", multsym}, {"/", slashsym},
+    {"=", eqsym}, {"<>", neqsym}, {"<", lessym}, {"<=", leqsym},
+    {">", gtrsym}, {">=", geqsym}, {"(", lparentsym}, {")", rparentsym},
+    {",", commasym}, {";", semicolonsym}, {".", periodsym}, {":=", becomessym},
+    {"begin", beginsym}, {"end", endsym}, {"if", ifsym}, {"fi", fisym},
+    {"then", thensym}, {"while", whilesym}, {"do", dosym}, {"call", callsym},
+    {"const", constsym}, {"var", varsym}, {"procedure", procsym}, {"write", writesym},
+    {"read", readsym}, {"else", elsesym}, {"even", evensym},
+};
+#endif
+
+#endif
@@ -0,0 +1,451 @@
+/*
+Generated by lexgen.c from lexspec.h; do not edit.
+205 states, 36 character classes.
+*/
+#ifndef LEXTAB_H
+#define LEXTAB_H
+#define LEX_STATES 205
+#define LEX_CLASSES 36
+#define LEX_START 1
+#define LEX_COMMENT 203
+
+//Character class of each byte
+static const unsigned char lexClass[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 2, 3, 4, 5, 6, 7, 8, 9,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 12, 13, 14, 15, 0,
+    0, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 0, 0, 0, 0, 0,
+    0, 17, 18, 19, 20, 21, 22, 23, 24, 25, 16, 16, 26, 16, 27, 28,
+    29, 16, 30, 31, 32, 33, 34, 35, 16, 16, 16, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+//Next state by state and character class; 0 ends the token
+static const unsigned char lexNext[LEX_STATES][LEX_CLASSES] = {
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 0 DEAD
+    {2,1,139,140,131,129,141,130,143,132,4,144,142,134,133,137,3,3,146,169,167,151,156,3,3,154,3,3,3,180,193,3,158,3,177,162}, // 1 START
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 2 INVALID
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5}, // 3 IDENT_1
+    {0,0,0,0,0,0,0,0,0,0,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 4 NUMBER_1
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 5 IDENT_2
+    {0,0,0,0,0,0,0,0,0,0,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 6 NUMBER_2
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 7 IDENT_3
+    {0,0,0,0,0,0,0,0,0,0,10,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 8 NUMBER_3
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 9 IDENT_4
+    {0,0,0,0,0,0,0,0,0,0,12,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 10 NUMBER_4
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 11 IDENT_5
+    {0,0,0,0,0,0,0,0,0,0,14,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 12 NUMBER_5
+    {0,0,0,0,0,0,0,0,0,0,15,0,0,0,0,0,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15}, // 13 IDENT_6
+    {0,0,0,0,0,0,0,0,0,0,16,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 14 NUMBER_6
+    {0,0,0,0,0,0,0,0,0,0,17,0,0,0,0,0,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17,17}, // 15 IDENT_7
+    {0,0,0,0,0,0,0,0,0,0,18,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 16 NUMBER_7
+    {0,0,0,0,0,0,0,0,0,0,19,0,0,0,0,0,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19}, // 17 IDENT_8
+    {0,0,0,0,0,0,0,0,0,0,20,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 18 NUMBER_8
+    {0,0,0,0,0,0,0,0,0,0,21,0,0,0,0,0,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21}, // 19 IDENT_9
+    {0,0,0,0,0,0,0,0,0,0,22,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 20 NUMBER_9
+    {0,0,0,0,0,0,0,0,0,0,23,0,0,0,0,0,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23}, // 21 IDENT_10
+    {0,0,0,0,0,0,0,0,0,0,24,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 22 NUMBER_10
+    {0,0,0,0,0,0,0,0,0,0,25,0,0,0,0,0,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25}, // 23 IDENT_11
+    {0,0,0,0,0,0,0,0,0,0,26,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 24 NUMBER_11
+    {0,0,0,0,0,0,0,0,0,0,27,0,0,0,0,0,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27}, // 25 IDENT_12
+    {0,0,0,0,0,0,0,0,0,0,28,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 26 NUMBER_12
+    {0,0,0,0,0,0,0,0,0,0,29,0,0,0,0,0,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29}, // 27 IDENT_13
+    {0,0,0,0,0,0,0,0,0,0,30,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 28 NUMBER_13
+    {0,0,0,0,0,0,0,0,0,0,31,0,0,0,0,0,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31,31}, // 29 IDENT_14
+    {0,0,0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 30 NUMBER_14
+    {0,0,0,0,0,0,0,0,0,0,33,0,0,0,0,0,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33,33}, // 31 IDENT_15
+    {0,0,0,0,0,0,0,0,0,0,34,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 32 NUMBER_15
+    {0,0,0,0,0,0,0,0,0,0,35,0,0,0,0,0,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35,35}, // 33 IDENT_16
+    {0,0,0,0,0,0,0,0,0,0,36,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 34 NUMBER_16
+    {0,0,0,0,0,0,0,0,0,0,37,0,0,0,0,0,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37,37}, // 35 IDENT_17
+    {0,0,0,0,0,0,0,0,0,0,38,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 36 NUMBER_17
+    {0,0,0,0,0,0,0,0,0,0,39,0,0,0,0,0,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39}, // 37 IDENT_18
+    {0,0,0,0,0,0,0,0,0,0,40,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 38 NUMBER_18
+    {0,0,0,0,0,0,0,0,0,0,41,0,0,0,0,0,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41,41}, // 39 IDENT_19
+    {0,0,0,0,0,0,0,0,0,0,42,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 40 NUMBER_19
+    {0,0,0,0,0,0,0,0,0,0,43,0,0,0,0,0,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43}, // 41 IDENT_20
+    {0,0,0,0,0,0,0,0,0,0,44,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 42 NUMBER_20
+    {0,0,0,0,0,0,0,0,0,0,45,0,0,0,0,0,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45,45}, // 43 IDENT_21
+    {0,0,0,0,0,0,0,0,0,0,46,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 44 NUMBER_21
+    {0,0,0,0,0,0,0,0,0,0,47,0,0,0,0,0,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47,47}, // 45 IDENT_22
+    {0,0,0,0,0,0,0,0,0,0,48,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 46 NUMBER_22
+    {0,0,0,0,0,0,0,0,0,0,49,0,0,0,0,0,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49,49}, // 47 IDENT_23
+    {0,0,0,0,0,0,0,0,0,0,50,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 48 NUMBER_23
+    {0,0,0,0,0,0,0,0,0,0,51,0,0,0,0,0,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51,51}, // 49 IDENT_24
+    {0,0,0,0,0,0,0,0,0,0,52,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 50 NUMBER_24
+    {0,0,0,0,0,0,0,0,0,0,53,0,0,0,0,0,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53,53}, // 51 IDENT_25
+    {0,0,0,0,0,0,0,0,0,0,54,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 52 NUMBER_25
+    {0,0,0,0,0,0,0,0,0,0,55,0,0,0,0,0,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55,55}, // 53 IDENT_26
+    {0,0,0,0,0,0,0,0,0,0,56,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 54 NUMBER_26
+    {0,0,0,0,0,0,0,0,0,0,57,0,0,0,0,0,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57,57}, // 55 IDENT_27
+    {0,0,0,0,0,0,0,0,0,0,58,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 56 NUMBER_27
+    {0,0,0,0,0,0,0,0,0,0,59,0,0,0,0,0,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59,59}, // 57 IDENT_28
+    {0,0,0,0,0,0,0,0,0,0,60,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 58 NUMBER_28
+    {0,0,0,0,0,0,0,0,0,0,61,0,0,0,0,0,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61,61}, // 59 IDENT_29
+    {0,0,0,0,0,0,0,0,0,0,62,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 60 NUMBER_29
+    {0,0,0,0,0,0,0,0,0,0,63,0,0,0,0,0,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63,63}, // 61 IDENT_30
+    {0,0,0,0,0,0,0,0,0,0,64,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 62 NUMBER_30
+    {0,0,0,0,0,0,0,0,0,0,65,0,0,0,0,0,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65}, // 63 IDENT_31
+    {0,0,0,0,0,0,0,0,0,0,66,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 64 NUMBER_31
+    {0,0,0,0,0,0,0,0,0,0,67,0,0,0,0,0,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67,67}, // 65 IDENT_32
+    {0,0,0,0,0,0,0,0,0,0,68,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 66 NUMBER_32
+    {0,0,0,0,0,0,0,0,0,0,69,0,0,0,0,0,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69,69}, // 67 IDENT_33
+    {0,0,0,0,0,0,0,0,0,0,70,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 68 NUMBER_33
+    {0,0,0,0,0,0,0,0,0,0,71,0,0,0,0,0,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71,71}, // 69 IDENT_34
+    {0,0,0,0,0,0,0,0,0,0,72,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 70 NUMBER_34
+    {0,0,0,0,0,0,0,0,0,0,73,0,0,0,0,0,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73,73}, // 71 IDENT_35
+    {0,0,0,0,0,0,0,0,0,0,74,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 72 NUMBER_35
+    {0,0,0,0,0,0,0,0,0,0,75,0,0,0,0,0,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75,75}, // 73 IDENT_36
+    {0,0,0,0,0,0,0,0,0,0,76,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 74 NUMBER_36
+    {0,0,0,0,0,0,0,0,0,0,77,0,0,0,0,0,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77,77}, // 75 IDENT_37
+    {0,0,0,0,0,0,0,0,0,0,78,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 76 NUMBER_37
+    {0,0,0,0,0,0,0,0,0,0,79,0,0,0,0,0,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79,79}, // 77 IDENT_38
+    {0,0,0,0,0,0,0,0,0,0,80,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 78 NUMBER_38
+    {0,0,0,0,0,0,0,0,0,0,81,0,0,0,0,0,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81,81}, // 79 IDENT_39
+    {0,0,0,0,0,0,0,0,0,0,82,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 80 NUMBER_39
+    {0,0,0,0,0,0,0,0,0,0,83,0,0,0,0,0,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83,83}, // 81 IDENT_40
+    {0,0,0,0,0,0,0,0,0,0,84,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 82 NUMBER_40
+    {0,0,0,0,0,0,0,0,0,0,85,0,0,0,0,0,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85}, // 83 IDENT_41
+    {0,0,0,0,0,0,0,0,0,0,86,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 84 NUMBER_41
+    {0,0,0,0,0,0,0,0,0,0,87,0,0,0,0,0,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87}, // 85 IDENT_42
+    {0,0,0,0,0,0,0,0,0,0,88,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 86 NUMBER_42
+    {0,0,0,0,0,0,0,0,0,0,89,0,0,0,0,0,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89,89}, // 87 IDENT_43
+    {0,0,0,0,0,0,0,0,0,0,90,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 88 NUMBER_43
+    {0,0,0,0,0,0,0,0,0,0,91,0,0,0,0,0,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91,91}, // 89 IDENT_44
+    {0,0,0,0,0,0,0,0,0,0,92,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 90 NUMBER_44
+    {0,0,0,0,0,0,0,0,0,0,93,0,0,0,0,0,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93,93}, // 91 IDENT_45
+    {0,0,0,0,0,0,0,0,0,0,94,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 92 NUMBER_45
+    {0,0,0,0,0,0,0,0,0,0,95,0,0,0,0,0,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95,95}, // 93 IDENT_46
+    {0,0,0,0,0,0,0,0,0,0,96,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 94 NUMBER_46
+    {0,0,0,0,0,0,0,0,0,0,97,0,0,0,0,0,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97,97}, // 95 IDENT_47
+    {0,0,0,0,0,0,0,0,0,0,98,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 96 NUMBER_47
+    {0,0,0,0,0,0,0,0,0,0,99,0,0,0,0,0,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99}, // 97 IDENT_48
+    {0,0,0,0,0,0,0,0,0,0,100,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 98 NUMBER_48
+    {0,0,0,0,0,0,0,0,0,0,101,0,0,0,0,0,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101,101}, // 99 IDENT_49
+    {0,0,0,0,0,0,0,0,0,0,102,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 100 NUMBER_49
+    {0,0,0,0,0,0,0,0,0,0,103,0,0,0,0,0,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103,103}, // 101 IDENT_50
+    {0,0,0,0,0,0,0,0,0,0,104,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 102 NUMBER_50
+    {0,0,0,0,0,0,0,0,0,0,105,0,0,0,0,0,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105,105}, // 103 IDENT_51
+    {0,0,0,0,0,0,0,0,0,0,106,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 104 NUMBER_51
+    {0,0,0,0,0,0,0,0,0,0,107,0,0,0,0,0,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107,107}, // 105 IDENT_52
+    {0,0,0,0,0,0,0,0,0,0,108,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 106 NUMBER_52
+    {0,0,0,0,0,0,0,0,0,0,109,0,0,0,0,0,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109,109}, // 107 IDENT_53
+    {0,0,0,0,0,0,0,0,0,0,110,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 108 NUMBER_53
+    {0,0,0,0,0,0,0,0,0,0,111,0,0,0,0,0,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111,111}, // 109 IDENT_54
+    {0,0,0,0,0,0,0,0,0,0,112,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 110 NUMBER_54
+    {0,0,0,0,0,0,0,0,0,0,113,0,0,0,0,0,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113,113}, // 111 IDENT_55
+    {0,0,0,0,0,0,0,0,0,0,114,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 112 NUMBER_55
+    {0,0,0,0,0,0,0,0,0,0,115,0,0,0,0,0,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115,115}, // 113 IDENT_56
+    {0,0,0,0,0,0,0,0,0,0,116,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 114 NUMBER_56
+    {0,0,0,0,0,0,0,0,0,0,117,0,0,0,0,0,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117,117}, // 115 IDENT_57
+    {0,0,0,0,0,0,0,0,0,0,118,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 116 NUMBER_57
+    {0,0,0,0,0,0,0,0,0,0,119,0,0,0,0,0,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119,119}, // 117 IDENT_58
+    {0,0,0,0,0,0,0,0,0,0,120,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 118 NUMBER_58
+    {0,0,0,0,0,0,0,0,0,0,121,0,0,0,0,0,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121}, // 119 IDENT_59
+    {0,0,0,0,0,0,0,0,0,0,122,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 120 NUMBER_59
+    {0,0,0,0,0,0,0,0,0,0,123,0,0,0,0,0,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123,123}, // 121 IDENT_60
+    {0,0,0,0,0,0,0,0,0,0,124,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 122 NUMBER_60
+    {0,0,0,0,0,0,0,0,0,0,125,0,0,0,0,0,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125}, // 123 IDENT_61
+    {0,0,0,0,0,0,0,0,0,0,126,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 124 NUMBER_61
+    {0,0,0,0,0,0,0,0,0,0,127,0,0,0,0,0,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127}, // 125 IDENT_62
+    {0,0,0,0,0,0,0,0,0,0,128,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 126 NUMBER_62
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 127 IDENT_63
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 128 NUMBER_63
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 129 "+"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 130 "-"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 131 "*"
+    {0,0,0,0,203,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 132 "/"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 133 "="
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,136,135,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 134 "<"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 135 "<>"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 136 "<="
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,138,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 137 ">"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 138 ">="
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 139 "("
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 140 ")"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 141 ","
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 142 ";"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 143 "."
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,145,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 144 ":"
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // 145 ":="
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,147,5,5,5,5,5,5,5,5,5,5,5,5,5,5}, // 146 "b"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,148,7,7,7,7,7,7,7,7,7,7,7,7}, // 147 "be"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,149,9,9,9,9,9,9,9,9,9,9}, // 148 "beg"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,150,11,11,11,11,11,11,11,11}, // 149 "begi"
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 150 "begin"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,5,5,197,152,5,5,5,5,5,5,200,5}, // 151 "e"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,153,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 152 "en"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 153 "end"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,155,5,5,5,5,5,5,5,5,5,5,5,5,5}, // 154 "i"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 155 "if"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,5,157,5,5,5,5,5,5,5,5,5,5}, // 156 "f"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 157 "fi"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,159,5,5,5,5,5,5,5,5,5,5,5}, // 158 "t"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,160,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 159 "th"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,161,9,9,9,9,9,9,9,9}, // 160 "the"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 161 "then"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,163,5,5,5,5,5,189,5,5,5,5,5}, // 162 "w"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,164,7,7,7,7,7,7,7,7,7,7}, // 163 "wh"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,165,9,9,9,9,9,9,9,9,9}, // 164 "whi"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,166,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 165 "whil"
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 166 "while"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,5,5,5,5,168,5,5,5,5,5,5,5}, // 167 "d"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 168 "do"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,170,5,5,5,5,5,5,5,5,5,5,173,5,5,5,5,5,5,5}, // 169 "c"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,171,7,7,7,7,7,7,7,7,7}, // 170 "ca"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,172,9,9,9,9,9,9,9,9,9}, // 171 "cal"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 172 "call"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,174,7,7,7,7,7,7,7,7}, // 173 "co"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,175,9,9,9,9}, // 174 "con"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,176,11,11,11}, // 175 "cons"
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 176 "const"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,178,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5}, // 177 "v"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,179,7,7,7,7,7}, // 178 "va"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 179 "var"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,5,5,5,5,5,5,5,5,5,181,5,5,5,5,5}, // 180 "p"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,182,7,7,7,7,7,7,7}, // 181 "pr"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,183,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 182 "pro"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,184,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 183 "proc"
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,185,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 184 "proce"
+    {0,0,0,0,0,0,0,0,0,0,15,0,0,0,0,0,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,186,15,15}, // 185 "proced"
+    {0,0,0,0,0,0,0,0,0,0,17,0,0,0,0,0,17,17,17,17,17,17,17,17,17,17,17,17,17,17,187,17,17,17,17,17}, // 186 "procedu"
+    {0,0,0,0,0,0,0,0,0,0,19,0,0,0,0,0,19,19,19,19,19,188,19,19,19,19,19,19,19,19,19,19,19,19,19,19}, // 187 "procedur"
+    {0,0,0,0,0,0,0,0,0,0,21,0,0,0,0,0,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21}, // 188 "procedure"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,190,7,7,7,7,7,7,7,7,7,7}, // 189 "wr"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,191,9,9,9}, // 190 "wri"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,192,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 191 "writ"
+    {0,0,0,0,0,0,0,0,0,0,13,0,0,0,0,0,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13}, // 192 "write"
+    {0,0,0,0,0,0,0,0,0,0,5,0,0,0,0,0,5,5,5,5,5,194,5,5,5,5,5,5,5,5,5,5,5,5,5,5}, // 193 "r"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,195,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 194 "re"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,196,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 195 "rea"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 196 "read"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,198,7,7,7,7}, // 197 "el"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,199,9,9,9,9,9,9,9,9,9,9,9,9,9,9}, // 198 "els"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 199 "else"
+    {0,0,0,0,0,0,0,0,0,0,7,0,0,0,0,0,7,7,7,7,7,201,7,7,7,7,7,7,7,7,7,7,7,7,7,7}, // 200 "ev"
+    {0,0,0,0,0,0,0,0,0,0,9,0,0,0,0,0,9,9,9,9,9,9,9,9,9,9,9,202,9,9,9,9,9,9,9,9}, // 201 "eve"
+    {0,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11}, // 202 "even"
+    {203,203,203,203,204,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203}, // 203 COMMENT
+    {203,203,203,203,204,203,203,203,203,1,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203,203}, // 204 COMMENT_STAR
+};
+
+//Token produced when a state ends: type, error code, lexeme length (0: all characters read)
+static const struct {
+    unsigned char type, errors, len;
+} lexAccept[LEX_STATES] = {
+    {0, 0, 0}, // 0 DEAD
+    {1, 0, 0}, // 1 START
+    {0, 2, 0}, // 2 INVALID
+    {2, 0, 0}, // 3 IDENT_1
+    {3, 0, 0}, // 4 NUMBER_1
+    {2, 0, 0}, // 5 IDENT_2
+    {3, 0, 0}, // 6 NUMBER_2
+    {2, 0, 0}, // 7 IDENT_3
+    {3, 0, 0}, // 8 NUMBER_3
+    {2, 0, 0}, // 9 IDENT_4
+    {3, 0, 0}, // 10 NUMBER_4
+    {2, 0, 0}, // 11 IDENT_5
+    {3, 0, 0}, // 12 NUMBER_5
+    {2, 0, 0}, // 13 IDENT_6
+    {0, 1, 0}, // 14 NUMBER_6
+    {2, 0, 0}, // 15 IDENT_7
+    {0, 1, 0}, // 16 NUMBER_7
+    {2, 0, 0}, // 17 IDENT_8
+    {0, 1, 0}, // 18 NUMBER_8
+    {2, 0, 0}, // 19 IDENT_9
+    {0, 1, 0}, // 20 NUMBER_9
+    {2, 0, 0}, // 21 IDENT_10
+    {0, 1, 0}, // 22 NUMBER_10
+    {2, 0, 0}, // 23 IDENT_11
+    {0, 1, 0}, // 24 NUMBER_11
+    {0, 0, 0}, // 25 IDENT_12
+    {0, 1, 0}, // 26 NUMBER_12
+    {0, 0, 0}, // 27 IDENT_13
+    {0, 1, 0}, // 28 NUMBER_13
+    {0, 0, 0}, // 29 IDENT_14
+    {0, 1, 0}, // 30 NUMBER_14
+    {0, 0, 0}, // 31 IDENT_15
+    {0, 1, 0}, // 32 NUMBER_15
+    {0, 0, 0}, // 33 IDENT_16
+    {0, 1, 0}, // 34 NUMBER_16
+    {0, 0, 0}, // 35 IDENT_17
+    {0, 1, 0}, // 36 NUMBER_17
+    {0, 0, 0}, // 37 IDENT_18
+    {0, 1, 0}, // 38 NUMBER_18
+    {0, 0, 0}, // 39 IDENT_19
+    {0, 1, 0}, // 40 NUMBER_19
+    {0, 0, 0}, // 41 IDENT_20
+    {0, 1, 0}, // 42 NUMBER_20
+    {0, 0, 0}, // 43 IDENT_21
+    {0, 1, 0}, // 44 NUMBER_21
+    {0, 0, 0}, // 45 IDENT_22
+    {0, 1, 0}, // 46 NUMBER_22
+    {0, 0, 0}, // 47 IDENT_23
+    {0, 1, 0}, // 48 NUMBER_23
+    {0, 0, 0}, // 49 IDENT_24
+    {0, 1, 0}, // 50 NUMBER_24
+    {0, 0, 0}, // 51 IDENT_25
+    {0, 1, 0}, // 52 NUMBER_25
+    {0, 0, 0}, // 53 IDENT_26
+    {0, 1, 0}, // 54 NUMBER_26
+    {0, 0, 0}, // 55 IDENT_27
+    {0, 1, 0}, // 56 NUMBER_27
+    {0, 0, 0}, // 57 IDENT_28
+    {0, 1, 0}, // 58 NUMBER_28
+    {0, 0, 0}, // 59 IDENT_29
+    {0, 1, 0}, // 60 NUMBER_29
+    {0, 0, 0}, // 61 IDENT_30
+    {0, 1, 0}, // 62 NUMBER_30
+    {0, 0, 0}, // 63 IDENT_31
+    {0, 1, 0}, // 64 NUMBER_31
+    {0, 0, 0}, // 65 IDENT_32
+    {0, 1, 0}, // 66 NUMBER_32
+    {0, 0, 0}, // 67 IDENT_33
+    {0, 1, 0}, // 68 NUMBER_33
+    {0, 0, 0}, // 69 IDENT_34
+    {0, 1, 0}, // 70 NUMBER_34
+    {0, 0, 0}, // 71 IDENT_35
+    {0, 1, 0}, // 72 NUMBER_35
+    {0, 0, 0}, // 73 IDENT_36
+    {0, 1, 0}, // 74 NUMBER_36
+    {0, 0, 0}, // 75 IDENT_37
+    {0, 1, 0}, // 76 NUMBER_37
+    {0, 0, 0}, // 77 IDENT_38
+    {0, 1, 0}, // 78 NUMBER_38
+    {0, 0, 0}, // 79 IDENT_39
+    {0, 1, 0}, // 80 NUMBER_39
+    {0, 0, 0}, // 81 IDENT_40
+    {0, 1, 0}, // 82 NUMBER_40
+    {0, 0, 0}, // 83 IDENT_41
+    {0, 1, 0}, // 84 NUMBER_41
+    {0, 0, 0}, // 85 IDENT_42
+    {0, 1, 0}, // 86 NUMBER_42
+    {0, 0, 0}, // 87 IDENT_43
+    {0, 1, 0}, // 88 NUMBER_43
+    {0, 0, 0}, // 89 IDENT_44
+    {0, 1, 0}, // 90 NUMBER_44
+    {0, 0, 0}, // 91 IDENT_45
+    {0, 1, 0}, // 92 NUMBER_45
+    {0, 0, 0}, // 93 IDENT_46
+    {0, 1, 0}, // 94 NUMBER_46
+    {0, 0, 0}, // 95 IDENT_47
+    {0, 1, 0}, // 96 NUMBER_47
+    {0, 0, 0}, // 97 IDENT_48
+    {0, 1, 0}, // 98 NUMBER_48
+    {0, 0, 0}, // 99 IDENT_49
+    {0, 1, 0}, // 100 NUMBER_49
+    {0, 0, 0}, // 101 IDENT_50
+    {0, 1, 0}, // 102 NUMBER_50
+    {0, 0, 0}, // 103 IDENT_51
+    {0, 1, 0}, // 104 NUMBER_51
+    {0, 0, 0}, // 105 IDENT_52
+    {0, 1, 0}, // 106 NUMBER_52
+    {0, 0, 0}, // 107 IDENT_53
+    {0, 1, 0}, // 108 NUMBER_53
+    {0, 0, 0}, // 109 IDENT_54
+    {0, 1, 0}, // 110 NUMBER_54
+    {0, 0, 0}, // 111 IDENT_55
+    {0, 1, 0}, // 112 NUMBER_55
+    {0, 0, 0}, // 113 IDENT_56
+    {0, 1, 0}, // 114 NUMBER_56
+    {0, 0, 0}, // 115 IDENT_57
+    {0, 1, 0}, // 116 NUMBER_57
+    {0, 0, 0}, // 117 IDENT_58
+    {0, 1, 0}, // 118 NUMBER_58
+    {0, 0, 0}, // 119 IDENT_59
+    {0, 1, 0}, // 120 NUMBER_59
+    {0, 0, 0}, // 121 IDENT_60
+    {0, 1, 0}, // 122 NUMBER_60
+    {0, 0, 0}, // 123 IDENT_61
+    {0, 1, 0}, // 124 NUMBER_61
+    {0, 0, 0}, // 125 IDENT_62
+    {0, 1, 0}, // 126 NUMBER_62
+    {0, 0, 0}, // 127 IDENT_63
+    {0, 1, 0}, // 128 NUMBER_63
+    {4, 0, 0}, // 129 "+"
+    {5, 0, 0}, // 130 "-"
+    {6, 0, 0}, // 131 "*"
+    {7, 0, 0}, // 132 "/"
+    {8, 0, 0}, // 133 "="
+    {10, 0, 0}, // 134 "<"
+    {9, 0, 0}, // 135 "<>"
+    {11, 0, 0}, // 136 "<="
+    {12, 0, 0}, // 137 ">"
+    {13, 0, 0}, // 138 ">="
+    {14, 0, 0}, // 139 "("
+    {15, 0, 0}, // 140 ")"
+    {16, 0, 0}, // 141 ","
+    {17, 0, 0}, // 142 ";"
+    {18, 0, 0}, // 143 "."
+    {0, 2, 0}, // 144 ":"
+    {19, 0, 0}, // 145 ":="
+    {2, 0, 0}, // 146 "b"
+    {2, 0, 0}, // 147 "be"
+    {2, 0, 0}, // 148 "beg"
+    {2, 0, 0}, // 149 "begi"
+    {20, 0, 0}, // 150 "begin"
+    {2, 0, 0}, // 151 "e"
+    {2, 0, 0}, // 152 "en"
+    {21, 0, 0}, // 153 "end"
+    {2, 0, 0}, // 154 "i"
+    {22, 0, 0}, // 155 "if"
+    {2, 0, 0}, // 156 "f"
+    {23, 0, 0}, // 157 "fi"
+    {2, 0, 0}, // 158 "t"
+    {2, 0, 0}, // 159 "th"
+    {2, 0, 0}, // 160 "the"
+    {24, 0, 0}, // 161 "then"
+    {2, 0, 0}, // 162 "w"
+    {2, 0, 0}, // 163 "wh"
+    {2, 0, 0}, // 164 "whi"
+    {2, 0, 0}, // 165 "whil"
+    {25, 0, 0}, // 166 "while"
+    {2, 0, 0}, // 167 "d"
+    {26, 0, 0}, // 168 "do"
+    {2, 0, 0}, // 169 "c"
+    {2, 0, 0}, // 170 "ca"
+    {2, 0, 0}, // 171 "cal"
+    {27, 0, 0}, // 172 "call"
+    {2, 0, 0}, // 173 "co"
+    {2, 0, 0}, // 174 "con"
+    {2, 0, 0}, // 175 "cons"
+    {28, 0, 0}, // 176 "const"
+    {2, 0, 0}, // 177 "v"
+    {2, 0, 0}, // 178 "va"
+    {29, 0, 0}, // 179 "var"
+    {2, 0, 0}, // 180 "p"
+    {2, 0, 0}, // 181 "pr"
+    {2, 0, 0}, // 182 "pro"
+    {2, 0, 0}, // 183 "proc"
+    {2, 0, 0}, // 184 "proce"
+    {2, 0, 0}, // 185 "proced"
+    {2, 0, 0}, // 186 "procedu"
+    {2, 0, 0}, // 187 "procedur"
+    {30, 0, 0}, // 188 "procedure"
+    {2, 0, 0}, // 189 "wr"
+    {2, 0, 0}, // 190 "wri"
+    {2, 0, 0}, // 191 "writ"
+    {31, 0, 0}, // 192 "write"
+    {2, 0, 0}, // 193 "r"
+    {2, 0, 0}, // 194 "re"
+    {2, 0, 0}, // 195 "rea"
+    {32, 0, 0}, // 196 "read"
+    {2, 0, 0}, // 197 "el"
+    {2, 0, 0}, // 198 "els"
+    {33, 0, 0}, // 199 "else"
+    {2, 0, 0}, // 200 "ev"
+    {2, 0, 0}, // 201 "eve"
+    {34, 0, 0}, // 202 "even"
+    {0, 3, 2}, // 203 COMMENT
+    {0, 3, 2}, // 204 COMMENT_STAR
+};
+#endif
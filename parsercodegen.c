@@ -9,15 +9,27 @@
 // Parser/Code Generator:
 // gcc -O2 -std=c11 -o parsercodegen parsercodegen.c
 // To Execute (on Eustis):
-// ./lex <input_file.txt>
-// ./parsercodegen
+// ./lex [-g] [-b] <input_file.txt>
+// ./parsercodegen [-O] [-g] [-b] [--packed] [--time-passes] [--stats|--stats-json] [--dump-after <pass|all>]
 // where:
 // <input_file.txt> is the path to the PL/0 source program
+// -O enables the optimization passes (tail calls use the TCL opcode,
+//    small non-recursive procedures are inlined at their call sites)
+// -g reads tokens.pos (from ./lex -g), reports error positions and writes
+//    elf.dbg, the instruction-to-source-line table
+// -b reads tokens.bin (from ./lex -b) instead of tokens.txt
+// --packed also writes elf.bin, the program as packed 32-bit words (pm0pack.h)
+// --time-passes prints the time spent in each compiler pass to stderr
+// --stats (or --stats-json) prints wall time and counters for every phase
+//    to stderr, from token loading to the listing
+// --dump-after <pass|all> prints the AST or code after that pass to stderr
 // Notes:\
 // - lex.c accepts ONE command-line argument (input PL/0 source file)
-// - parsercodegen.c accepts NO command-line arguments
+// - parsercodegen.c accepts only option flags (no file names)
 // - Input filename is hard-coded in parsercodegen.c
-// - Implements recursive-descent parser for PL/0 grammar
+// - Implements recursive-descent parser for PL/0 grammar that builds an AST;
+//   passes run over it before code generation, then over the code
+// - Supports nested procedures and call statements with lexical levels
 // - Generates PM/0 assembly code (see Appendix A for ISA)
 // - All development and testing performed on Eustis
 // Class: COP3402 - System Software - Fall 2025
@@ -26,9 +38,21 @@
 // */
 
 //Standard Headers
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//Mid-level IR (basic blocks, CFG, SSA over frame cells), shared with pm0opt.c
+#include "pm0ir.h"
+#include "pm0pack.h"
+#include "pm0tokens.h"
 
 //Token IDs defined as global constants
 #define errorsym       0   // invalid to print (not used for skip detection)
@@ -58,10 +82,10 @@
 #define thensym        24  // then
 #define whilesym       25  // while
 #define dosym          26  // do
-#define callsym        27  // call (unused in HW3)
+#define callsym        27  // call
 #define constsym       28  // const
 #define varsym         29  // var
-#define procsym        30  // procedure (unused in HW3)
+#define procsym        30  // procedure
 #define writesym       31  // write
 #define readsym        32  // read
 #define elsesym        33  // else (unused in HW3)
@@ -71,12 +95,13 @@
 //PM/0 Instruction + Code Buffer
 typedef struct {
   int op; // opcode
-  int l;  // level (always 0 in HW3)
+  int l;  // lexical level difference
   int m;  // modifier / address / immediate
 } instruction;
 
 #define MAX_CODE_LENGTH 1000
 static instruction codebuf[MAX_CODE_LENGTH];
+static int codeLine[MAX_CODE_LENGTH]; // source line of each instruction (-g)
 static int cx = 0; // instruction index
 
 //OPcodes
@@ -89,6 +114,7 @@ static int cx = 0; // instruction index
 #define OP_JMP 7
 #define OP_JPC 8
 #define OP_SYS 9
+#define OP_TCL 10 // tail call: CAL that reuses the caller's AR (-O only)
 
 //Function to convert the instruction index to word address
 static inline int WA(int instr_index) { return instr_index * 3; }
@@ -108,11 +134,11 @@ static inline int WA(int instr_index) { return instr_index * 3; }
 
 //Symbol Table
 typedef struct {
-  int  kind;      // 1 = const, 2 = var
+  int  kind;      // 1 = const, 2 = var, 3 = procedure
   char name[12];  // identifier (<= 11 chars)
-  int  val;       // const value
-  int  level;     // always 0
-  int  addr;      // var address (for LOD/STO)
+  int  val;       // const value, procedure table index for procedures
+  int  level;     // lexical level of the declaring block
+  int  addr;      // var address (for LOD/STO), code address for procedures
   int  mark;      // 0 active, 1 marked
 } symbol;
 
@@ -123,23 +149,107 @@ static int symCount = 0;
 //Variable Address
 static int nextVarAddr = 3;
 
-//Token Buffer Read from tokens.txt
+//Current lexical level (0 = main block)
+static int level = 0;
+
+//Procedure Table (entry 0 is the main block)
 typedef struct {
-  int  type;       // token type number
-  char lexeme[64]; // text for ident/number
-  int  hasLexeme;  // 1 if lexeme present
-} TokenRec;
+  int level;      // lexical level of the procedure's own block
+  int entry;      // instruction index of the first instruction
+  int incIdx;     // instruction index of the block's INC
+  int end;        // instruction index of the closing RTN (-1 while compiling)
+  int nvars;      // declared variables
+  int temps;      // frame cells for hoisted loop invariants (-O)
+  int scratch;    // extra frame cells for inlined callees' variables
+  int hasNested;  // 1 if it declares procedures of its own
+  int parent;     // enclosing procedure (-1 for main)
+  int dead;       // 1 once -O has removed its code as unreachable
+  int frame;      // final INC size (links + variables + temps + scratch)
+  int maxOps;     // deepest operand stack above the frame
+  int need;       // worst-case stack cells for a call, -1 if recursive
+  int state;      // stack analysis: 0 new, 1 in progress, 2 done
+} procinfo;
+
+#define MAX_PROCS 100
+static procinfo proc_table[MAX_PROCS];
+static int procCount = 0;
+static int curProc = 0; // procedure whose block is being compiled
+
+//Procedures with at most this many body instructions are inlined under -O
+#define INLINE_MAX_INSTRS 24
+
+//Optimization flag (-O)
+static int optimize = 0;
+
+//Debug info flag (-g)
+static int debugInfo = 0;
+
+//Packed object flag (--packed)
+static int packedOutput = 0;
+
+//Source line used by emit() for the instructions being generated
+static int genLine = 0;
+
+//Compile statistics (--stats, --stats-json): counters kept by the parser and code generator
+#define STATS_TEXT 1
+#define STATS_JSON 2
+static int statsFormat = 0;
+static struct {
+  long symbols;       // symbols added to the symbol table
+  long lookups;       // findSymbol calls
+  long probes;        // symbol table entries compared by them
+  long maxProbe;      // longest single lookup
+  long emitted[16];   // instructions emitted, by opcode
+  long backpatches;   // jump targets filled in after the jump was emitted
+} stats;
+
+//Phases outside the pass manager, timed for --stats
+enum { PH_TOKEN_LOAD, PH_SKIPSYM, PH_WRITE_ELF, PH_WRITE_PACKED, PH_WRITE_DEBUG, PH_LISTING, PH_COUNT };
+static struct {
+  const char *name;
+  int runs;
+  double wall;  // seconds
+  long bytes;   // bytes read or written, -1 if not applicable
+} phases[PH_COUNT] = {
+  {"token-load", 0, 0, -1}, {"skipsym", 0, 0, -1}, {"write-elf", 0, 0, -1},
+  {"write-packed", 0, 0, -1}, {"write-debug", 0, 0, -1}, {"listing", 0, 0, -1},
+};
+
+//Function to read the wall clock in seconds
+static double wall_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-//Token Buffer Read from tokens.txt
+//Function to charge the time since start to a phase
+static void phase_done(int id, double start) {
+  phases[id].wall += wall_now() - start;
+  phases[id].runs++;
+}
+
+//Token stream as parallel arrays, read from tokens.txt or mapped straight from tokens.bin (-b)
 #define MAX_TOKENS 10000
-static TokenRec tokens[MAX_TOKENS];
+static const int32_t *tokType;  // token type number
+static const int32_t *tokVal;   // numbersym: value; identsym: offset of the name in tokStr
+static const char *tokStr;      // identifier names, NUL-terminated
+static int tokStrBytes = 0;
+static int tokLinePos[MAX_TOKENS], tokColPos[MAX_TOKENS]; // source position from tokens.pos (0 if unknown)
 static int tokCount = 0;
 static int t = 0; // current token index
 
+//Binary token input flag (-b)
+static int binaryTokens = 0;
+
 //helper function
 static int currentToken(void) 
 {
-  return (t < tokCount) ? tokens[t].type : eofsym;
+  return (t < tokCount) ? tokType[t] : eofsym;
+}
+//helper function to get the name of the current identifier token
+static const char *tokName(void)
+{
+  return (tokVal[t] >= 0 && tokVal[t] < tokStrBytes) ? tokStr + tokVal[t] : "";
 }
 //helper function to get next characteer
 static void advance(void) 
@@ -157,6 +267,9 @@ static void emit(int op, int l, int m)
   }
   //Add the opcode, level, and modifier to the code array
   codebuf[cx].op = op; codebuf[cx].l = l; codebuf[cx].m = m;
+  stats.emitted[op & 15]++;
+  //Attribute it to the source line of the node being generated
+  codeLine[cx] = genLine;
   cx++;
 }
 
@@ -166,6 +279,7 @@ static const char* op_mnemonic(int op)
   switch (op) {
     case OP_LIT: return "LIT"; case OP_OPR: return "OPR"; case OP_LOD: return "LOD"; case OP_STO: return "STO";
     case OP_CAL: return "CAL"; case OP_INC: return "INC"; case OP_JMP: return "JMP"; case OP_JPC: return "JPC"; case OP_SYS: return "SYS";
+    case OP_TCL: return "TCL";
     default: return "?";
   }
 }
@@ -176,12 +290,37 @@ static void write_elf(void) {
 
   //If the file cannot be opened, return an error
   if (!f) { printf("Error: could not open elf.txt for writing\n"); exit(1); }
+  //Header: worst-case stack cells for the whole program, then per procedure
+  //its entry instruction, frame size and deepest operand stack
+  fprintf(f, "# stack %d\n", proc_table[0].need);
+  for (int p = 0; p < procCount; p++) {
+    if (proc_table[p].dead) continue;
+    fprintf(f, "# proc %d frame %d depth %d\n", proc_table[p].entry, proc_table[p].frame, proc_table[p].maxOps);
+  }
   for (int i = 0; i < cx; i++) {
     fprintf(f, "%d %d %d\n", codebuf[i].op, codebuf[i].l, codebuf[i].m);
   }
+  phases[PH_WRITE_ELF].bytes = ftell(f);
   fclose(f);
 }
 
+//Function to write the packed object file elf.bin: one 32-bit word per instruction (--packed)
+static void write_packed(void) {
+  static int triples[3 * MAX_CODE_LENGTH];
+  static int32_t words[MAX_CODE_LENGTH], wide[2 * MAX_CODE_LENGTH];
+  for (int i = 0; i < cx; i++) {
+    triples[3 * i] = codebuf[i].op; triples[3 * i + 1] = codebuf[i].l; triples[3 * i + 2] = codebuf[i].m;
+  }
+  int bad;
+  int nwide = pm0pack_encode(triples, cx, words, wide, &bad);
+  FILE *f = fopen("elf.bin", "wb");
+  if (!f || nwide < 0 || !pm0pack_write(f, words, cx, wide, nwide, proc_table[0].need) ||
+      (phases[PH_WRITE_PACKED].bytes = ftell(f)) < 0 || fclose(f) != 0) {
+    printf("Error: could not write elf.bin\n");
+    exit(1);
+  }
+}
+
 //Function to print the code to the terminal
 static void print_code_to_terminal(void) {
   printf("Assembly Code:\n\n");
@@ -204,12 +343,18 @@ static void print_code_to_terminal(void) {
 
 //Error Handling
 static void fatal_error(const char *msg) {
-  printf("Error: %s\n", msg);
+  //With -g, point at the token where parsing stopped
+  char where[64] = "";
+  if (debugInfo && tokCount > 0) {
+    int at = (t < tokCount) ? t : tokCount - 1;
+    snprintf(where, sizeof(where), " (line %d, column %d)", tokLinePos[at], tokColPos[at]);
+  }
+  printf("Error: %s%s\n", msg, where);
 
   FILE *f = fopen("elf.txt", "w");
     if (f) 
     {
-        fprintf(f, "Error: %s\n", msg); fclose(f); 
+        fprintf(f, "Error: %s%s\n", msg, where); fclose(f); 
     }
   exit(1);
 }
@@ -231,23 +376,40 @@ static void err_while_do(void){ fatal_error("while must be followed by do"); }
 static void err_condition_relop(void){ fatal_error("condition must contain comparison operator"); }
 static void err_rparen_after_lparen(void){ fatal_error("right parenthesis must follow left parenthesis"); }
 static void err_arith_missing(void){ fatal_error("arithmetic equations must contain operands, parentheses, numbers, or symbols"); }
+static void err_id_after_proc(void){ fatal_error("procedure and call keywords must be followed by identifier"); }
+static void err_proc_semicolon(void){ fatal_error("procedure declarations must be followed by a semicolon"); }
+static void err_call_nonproc(void){ fatal_error("call statements may only target procedures"); }
+static void err_proc_in_expr(void){ fatal_error("procedure identifiers cannot be used in expressions"); }
 
 //Function to find the symbol in the symbol table
 static int findSymbol(const char *name) {
-  for (int i = symCount - 1; i >= 0; i--) {
-    if (!symbol_table[i].mark && strcmp(symbol_table[i].name, name) == 0) return i;
+  int i;
+  for (i = symCount - 1; i >= 0; i--) {
+    if (!symbol_table[i].mark && strcmp(symbol_table[i].name, name) == 0) break;
   }
-  return -1;
+  //Count the entries compared (--stats)
+  long probes = symCount - (i >= 0 ? i : 0);
+  stats.lookups++;
+  stats.probes += probes;
+  if (probes > stats.maxProbe) stats.maxProbe = probes;
+  return i;
+}
+
+//Function to check for a redeclaration in the current block
+static int declaredInBlock(const char *name) {
+  int idx = findSymbol(name);
+  return idx != -1 && symbol_table[idx].level == level;
 }
 
 //Function to add the constant to the symbol table
 static void addConst(const char *name, int value) {
   if (symCount >= MAX_SYMBOL_TABLE_SIZE) fatal_error("symbol table overflow");
+  stats.symbols++;
     symbol_table[symCount].kind = 1;
     strncpy(symbol_table[symCount].name, name, sizeof(symbol_table[symCount].name)-1);
     symbol_table[symCount].name[sizeof(symbol_table[symCount].name)-1] = '\0';
     symbol_table[symCount].val = value;
-    symbol_table[symCount].level = 0;
+    symbol_table[symCount].level = level;
     symbol_table[symCount].addr = 0;
     symbol_table[symCount].mark = 0;
     symCount++;
@@ -256,26 +418,97 @@ static void addConst(const char *name, int value) {
 //Function to add the variable to the symbol table
 static void addVar(const char *name, int addr) {
   if (symCount >= MAX_SYMBOL_TABLE_SIZE) fatal_error("symbol table overflow");
+  stats.symbols++;
     symbol_table[symCount].kind = 2;
     strncpy(symbol_table[symCount].name, name, sizeof(symbol_table[symCount].name)-1);
     symbol_table[symCount].name[sizeof(symbol_table[symCount].name)-1] = '\0';
     symbol_table[symCount].val = 0;
-    symbol_table[symCount].level = 0;
+    symbol_table[symCount].level = level;
     symbol_table[symCount].addr = addr;
   symbol_table[symCount].mark = 0;
   symCount++;
 }
 
+//Function to add the procedure to the symbol table and procedure table
+static int addProc(const char *name) {
+  if (symCount >= MAX_SYMBOL_TABLE_SIZE) fatal_error("symbol table overflow");
+  stats.symbols++;
+  if (procCount >= MAX_PROCS) fatal_error("too many procedures");
+  symbol_table[symCount].kind = 3;
+  snprintf(symbol_table[symCount].name, sizeof symbol_table[symCount].name, "%s", name);
+  symbol_table[symCount].val = procCount;
+  symbol_table[symCount].level = level;
+  symbol_table[symCount].addr = 0;   // set when its block starts
+  symbol_table[symCount].mark = 0;
+  memset(&proc_table[procCount], 0, sizeof(proc_table[procCount]));
+  proc_table[procCount].end = -1;
+  procCount++;
+  return symCount++;
+}
+
+//AST node kinds. The parser builds the whole program as a tree first;
+//gen_block() turns it into codebuf once the AST passes have run.
+#define N_NUM     1  // m = value
+#define N_VAR     2  // l = level difference, m = frame offset
+#define N_BIN     3  // op = OPR code; a, b = operands (b is NULL for OPR_ODD)
+#define N_ASSIGN  4  // l, m = target variable; a = value
+#define N_CALL    5  // l = level difference, m = procedure index
+#define N_SEQ     6  // begin ... end: a = first statement, linked through next
+#define N_IF      7  // a = condition, b = then statement
+#define N_WHILE   8  // a = condition, b = body
+#define N_READ    9  // l, m = target variable
+#define N_WRITE   10 // a = value
+#define N_EMPTY   11
+#define N_PROC    12 // m = procedure index, l = its symbol (-1 for main),
+                     // a = body, b = first nested N_PROC (linked through next)
+
+typedef struct node {
+  int kind, op, l, m;
+  int line;                 // source line (0 without -g)
+  struct node *a, *b, *next;
+} node;
+
+//Arena for AST nodes: bump allocation, never freed (the compiler exits after one program).
+//Each token yields at most two nodes, plus the empty statements between semicolons.
+#define MAX_NODES (2 * MAX_TOKENS + 1)
+static node arena[MAX_NODES];
+static int nodeCount = 0;
+static node *astRoot = NULL;
+
+//Function to get the source line of the current token
+static int tokLine(void) {
+  if (t < tokCount) return tokLinePos[t];
+  return (tokCount > 0) ? tokLinePos[tokCount - 1] : 0;
+}
+
+//Function to allocate a node from the arena
+static node *new_node(int kind, int line) {
+  if (nodeCount >= MAX_NODES) fatal_error("program too large");
+  node *n = &arena[nodeCount++];
+  n->kind = kind; n->op = 0; n->l = 0; n->m = 0;
+  n->line = line;
+  n->a = n->b = n->next = NULL;
+  return n;
+}
+
+//Function to build a binary operator node
+static node *new_bin(int op, node *a, node *b, int line) {
+  node *n = new_node(N_BIN, line);
+  n->op = op; n->a = a; n->b = b;
+  return n;
+}
+
 //Functions
 static void program(void);
-static void block(void);
+static node *block(int procIdx, int symIdx, int line);
 static void const_declaration(void);
 static int  var_declaration(void);
-static void statement(void);
-static void condition(void);
-static void expression(void);
-static void term(void);
-static void factor(void);
+static node *procedure_declaration(void);
+static node *statement(void);
+static node *condition(void);
+static node *expression(void);
+static node *term(void);
+static node *factor(void);
 
 //small parser helpers for clarity 
 static int accept(int ty) {
@@ -296,37 +529,77 @@ static int isRelOp(int ty) {
 //Function to parse the program
 static void program(void) {
   
-  //Emit the JMP opcode to jump to the start of the program
-  emit(OP_JMP, 0, 3);  /* JMP 0 3 */
+  //The main block is procedure 0 at level 0
+  procCount = 1;
+  proc_table[0].end = -1;
+  proc_table[0].parent = -1;
+  curProc = 0;
 
   //Function to parse the block
-  block();
+  astRoot = block(0, -1, tokLine());
 
   //If the current token is not periodsym, return an error
   expect_tok(periodsym, err_program_period);
-
-  //Emit the SYS opcode to halt the program
-  emit(OP_SYS, 0, 3);  
-
-  
 }
 
-//Function to parse the block
-static void block(void) {
+//Function to parse the block into an N_PROC node for procedure procIdx
+static node *block(int procIdx, int symIdx, int line) {
   int startSym = symCount; // save current symbol count before new declarations
+  int savedNextVarAddr = nextVarAddr;
+  nextVarAddr = 3;          // every AR starts with static link, dynamic link, return address
+  proc_table[procIdx].level = level;
+
+  node *n = new_node(N_PROC, line);
+  n->m = procIdx;
+  n->l = symIdx;
 
   const_declaration();
-  int nvars = var_declaration();
+  proc_table[procIdx].nvars = var_declaration();
 
-  //Function to reserve stack space: 3 + nvars
-  emit(OP_INC, 0, 3 + nvars);
+  //Nested procedures, then the block's own statement
+  n->b = procedure_declaration();
+  proc_table[procIdx].hasNested = (n->b != NULL);
+  n->a = statement();
 
-  //Function to parse the statement
-  statement();
-  // Mark symbols only if this is a nested block (but HW3 has no nested blocks/procedures)
+  //Mark this block's symbols so they go out of scope
    for (int i = startSym; i < symCount; i++) {
     symbol_table[i].mark = 1;
  }
+  nextVarAddr = savedNextVarAddr;
+  return n;
+}
+
+//Function to parse the procedure declarations into a list of N_PROC nodes
+static node *procedure_declaration(void)
+{
+  node *head = NULL, **tail = &head;
+  while (currentToken() == procsym) {
+    advance();
+
+    if (currentToken() != identsym) err_id_after_proc();
+    char name[64] = "";
+    strncpy(name, tokName(), sizeof(name)-1);
+    if (declaredInBlock(name)) err_symbol_redecl();
+    int symIdx = addProc(name);
+    int procIdx = symbol_table[symIdx].val;
+    int line = tokLine();
+    advance();
+
+    expect_tok(semicolonsym, err_proc_semicolon);
+
+    //The procedure's block is one level deeper
+    int savedProc = curProc;
+    proc_table[procIdx].parent = savedProc;
+    curProc = procIdx;
+    level++;
+    *tail = block(procIdx, symIdx, line);
+    tail = &(*tail)->next;
+    level--;
+    curProc = savedProc;
+
+    expect_tok(semicolonsym, err_proc_semicolon);
+  }
+  return head;
 }
 
 //Function to parse the const declaration
@@ -345,16 +618,16 @@ static void const_declaration(void)
 
     //Copy the lexeme to the name array
     char name[64] = "";
-    if (tokens[t].hasLexeme) strncpy(name, tokens[t].lexeme, sizeof(name)-1);
+    strncpy(name, tokName(), sizeof(name)-1);
 
-    if (findSymbol(name) != -1) err_symbol_redecl();
+    if (declaredInBlock(name)) err_symbol_redecl();
     advance();
 
     if (currentToken() != eqsym) err_const_assign_eq();
     advance();
 
     if (currentToken() != numbersym) err_const_int_value();
-    int val = 0; if (tokens[t].hasLexeme) val = atoi(tokens[t].lexeme);
+    int val = tokVal[t];
     addConst(name, val);
     advance();
 
@@ -379,9 +652,9 @@ static int var_declaration(void)
     if (currentToken() != identsym) err_id_after_kw();
 
     char name[64] = "";
-    if (tokens[t].hasLexeme) strncpy(name, tokens[t].lexeme, sizeof(name)-1);
+    strncpy(name, tokName(), sizeof(name)-1);
 
-    if (findSymbol(name) != -1) err_symbol_redecl();
+    if (declaredInBlock(name)) err_symbol_redecl();
     addVar(name, nextVarAddr++);
     count++;
 
@@ -395,35 +668,18 @@ static int var_declaration(void)
   return count;
 }
 
-//Function to emit the JPC opcode to jump to the next instruction
-static inline int emit_jpc_placeholder(void) 
-{ 
-  //Emit the JPC opcode to jump to the next instruction
-  emit(OP_JPC, 0, 0);
-  return cx - 1;
-}
-
-//Function to set the target instruction index
-static inline void set_target(int instr_index, int target_instr_index) {
-  codebuf[instr_index].m = WA(target_instr_index);
-}
-
-//Function to emit the JMP opcode to jump to the target instruction index
-static inline void emit_jmp_to(int target_instr_index) {
-  emit(OP_JMP, 0, WA(target_instr_index));
-}
-
 //Function to parse the statement
-static void statement(void) 
+static node *statement(void) 
 {
   int ty = currentToken();
+  int line = tokLine();
 
   //If the current token is identsym, parse the assignment and return
   if (ty == identsym) 
   {
     //Copy the lexeme to the name array
     char name[64] = "";
-    if (tokens[t].hasLexeme) strncpy(name, tokens[t].lexeme, sizeof(name)-1);
+    strncpy(name, tokName(), sizeof(name)-1);
     int idx = findSymbol(name);
     if (idx == -1) err_undeclared_ident();
     if (symbol_table[idx].kind != 2) err_only_var_assign();
@@ -437,12 +693,31 @@ static void statement(void)
     //Advance the token
     advance();
 
-    //Parse the expression
-    expression();
+    //Store the value of the expression into the variable
+    node *n = new_node(N_ASSIGN, line);
+    n->l = level - symbol_table[idx].level;
+    n->m = symbol_table[idx].addr;
+    n->a = expression();
+    return n;
+  }
+
+  //If the current token is callsym, call the procedure and return
+  if (ty == callsym)
+  {
+    advance();
+    if (currentToken() != identsym) err_id_after_proc();
 
-    //Emit the STO opcode to store the value
-    emit(OP_STO, 0, symbol_table[idx].addr); 
-    return;
+    char name[64] = "";
+    strncpy(name, tokName(), sizeof(name)-1);
+    int idx = findSymbol(name);
+    if (idx == -1) err_undeclared_ident();
+    if (symbol_table[idx].kind != 3) err_call_nonproc();
+
+    node *n = new_node(N_CALL, line);
+    n->l = level - symbol_table[idx].level;
+    n->m = symbol_table[idx].val;
+    advance();
+    return n;
   }
 
   //If the current token is beginsym, parse the statement and return
@@ -450,14 +725,17 @@ static void statement(void)
   {
     //Advance the token
     advance();
+    node *n = new_node(N_SEQ, line);
     //Parse the statement
-    statement();
+    n->a = statement();
+    node *last = n->a;
     //Loop to parse the next statement
     while (accept(semicolonsym)) {
-      statement();
+      last->next = statement();
+      last = last->next;
     }
     expect_tok(endsym, err_begin_end);
-    return;
+    return n;
   }
 
   //If the current token is ifsym, parse the condition and return
@@ -465,17 +743,14 @@ static void statement(void)
   {
     advance();
 
-    condition();
-
-    int jpcIdx = emit_jpc_placeholder();  /* JPC 0 ? */
+    node *n = new_node(N_IF, line);
+    n->a = condition();
 
     expect_tok(thensym, err_if_then);
-    statement();
-
-    set_target(jpcIdx, cx);               /* backpatch to next instr */
+    n->b = statement();
 
     if (accept(fisym)) { /* optional fi */ }
-    return;
+    return n;
   }
 
   //If the current token is whilesym, parse the condition and return
@@ -483,16 +758,13 @@ static void statement(void)
   {
     advance();
 
-    int loopStart = cx;
-    condition();
+    node *n = new_node(N_WHILE, line);
+    n->a = condition();
 
     expect_tok(dosym, err_while_do);
 
-    int jpcIdx = emit_jpc_placeholder();
-    statement();
-    emit_jmp_to(loopStart);
-    set_target(jpcIdx, cx);
-    return;
+    n->b = statement();
+    return n;
   }
 
   //If the current token is readsym, parse the identifier and return
@@ -502,47 +774,49 @@ static void statement(void)
     if (currentToken() != identsym) err_id_after_kw();
 
     char name[64] = "";
-    if (tokens[t].hasLexeme) strncpy(name, tokens[t].lexeme, sizeof(name)-1);
+    strncpy(name, tokName(), sizeof(name)-1);
     int idx = findSymbol(name);
     if (idx == -1) err_undeclared_ident();
     if (symbol_table[idx].kind != 2) err_only_var_assign();
 
-    emit(OP_SYS, 0, 2);                         /* read int */
-    emit(OP_STO, 0, symbol_table[idx].addr);    /* store */
+    node *n = new_node(N_READ, line);
+    n->l = level - symbol_table[idx].level;
+    n->m = symbol_table[idx].addr;
     advance();
-    return;
+    return n;
   }
 
   if (ty == writesym) 
   {
     advance();
-    expression();
-    emit(OP_SYS, 0, 1);                         /* write */
-    return;
+    node *n = new_node(N_WRITE, line);
+    n->a = expression();
+    return n;
   }
 
   /* epsilon/empty statement allowed */
+  return new_node(N_EMPTY, line);
 }
 
 //Function to parse the condition
-static void condition(void) {
+static node *condition(void) {
 
   //If the current token is evensym, parse the expression and return
   if (currentToken() == evensym) 
   {
+    int line = tokLine();
     advance();
-    expression();
-    emit(OP_OPR, 0, OPR_ODD);  //odd
-    return;
+    return new_bin(OPR_ODD, expression(), NULL, line);  //odd
   }
 
-  expression();
+  node *left = expression();
   int rel = currentToken();
+  int line = tokLine();
 
   //If the current token is not a relational operator, return an error
   if (!isRelOp(rel)) err_condition_relop();
   advance();
-  expression();
+  node *right = expression();
 
   int m = 0;
 
@@ -556,91 +830,295 @@ static void condition(void) {
     case geqsym: m = OPR_GEQ; break;
     default: err_condition_relop();
   }
-  emit(OP_OPR, 0, m);
+  return new_bin(m, left, right, line);
 }
 
 //Function to parse the expression
-static void expression(void) {
+static node *expression(void) {
 
   int leading = currentToken();
+  node *n;
 
   //If the current token is minussym, parse the expression and return
   if (leading == minussym) 
   {
+    int line = tokLine();
     advance();                 /* consume '-' */
-    emit(OP_LIT, 0, 0);        /* push 0 first */
-    term();                    /* parse the value */
-    emit(OP_OPR, 0, OPR_SUB);  /* 0 - value */
+    node *zero = new_node(N_NUM, line);  /* 0 - value */
+    n = new_bin(OPR_SUB, zero, term(), line);
   }
   else 
   {
 
     if (leading == plussym) advance();  /* optional '+' */
-    term();
+    n = term();
   }
 
   //If the current token is plussym or minussym, parse the expression and return
   while (currentToken() == plussym || currentToken() == minussym) 
   {
-    int op = currentToken(); advance();
-    term();
-    emit(OP_OPR, 0, (op==plussym) ? OPR_ADD : OPR_SUB);
+    int op = currentToken(), line = tokLine(); advance();
+    n = new_bin((op==plussym) ? OPR_ADD : OPR_SUB, n, term(), line);
   }
+  return n;
 }
 
 //Function to parse the term
-static void term(void) {
+static node *term(void) {
 
-  factor();
+  node *n = factor();
 
   //If the current token is multsym or slashsym, parse the term and return
   while (currentToken() == multsym || currentToken() == slashsym) {
-    int op = currentToken(); advance();
-    factor();
-    emit(OP_OPR, 0, (op==multsym) ? OPR_MUL : OPR_DIV);
+    int op = currentToken(), line = tokLine(); advance();
+    n = new_bin((op==multsym) ? OPR_MUL : OPR_DIV, n, factor(), line);
   }
+  return n;
 }
 
 //Function to parse the factor
-static void factor(void) 
+static node *factor(void) 
 {
   int ty = currentToken();
 
   //If the current token is identsym, parse the identifier and return
   if (ty == identsym) {
     char name[64] = "";
-    if (tokens[t].hasLexeme) strncpy(name, tokens[t].lexeme, sizeof(name)-1);
+    strncpy(name, tokName(), sizeof(name)-1);
     int idx = findSymbol(name);
     if (idx == -1) err_undeclared_ident();
 
+    if (symbol_table[idx].kind == 3) err_proc_in_expr();
+
+    node *n;
     if (symbol_table[idx].kind == 1) {
-      emit(OP_LIT, 0, symbol_table[idx].val);         /* const → LIT */
+      n = new_node(N_NUM, tokLine());                 /* const → LIT */
+      n->m = symbol_table[idx].val;
     } else {
-      emit(OP_LOD, 0, symbol_table[idx].addr);        /* var   → LOD */
+      n = new_node(N_VAR, tokLine());                 /* var → LOD */
+      n->l = level - symbol_table[idx].level;
+      n->m = symbol_table[idx].addr;
     }
     advance();
-    return;
+    return n;
   }
 
   //If the current token is numbersym, parse the value and return
   if (ty == numbersym) {
-    int val = 0; if (tokens[t].hasLexeme) val = atoi(tokens[t].lexeme);
-    emit(OP_LIT, 0, val);                             /* LIT value */
+    node *n = new_node(N_NUM, tokLine());             /* LIT value */
+    n->m = tokVal[t];
     advance();
-    return;
+    return n;
   }
 
   //If the current token is lparentsym, parse the expression and return
   if (ty == lparentsym) {
     advance();
-    expression();
+    node *n = expression();
     expect_tok(rparentsym, err_rparen_after_lparen);
-    return;
+    return n;
   }
 
   err_arith_missing();
+  return NULL;
+}
+
+//Function to emit the JPC opcode to jump to the next instruction
+static inline int emit_jpc_placeholder(void) 
+{ 
+  //Emit the JPC opcode to jump to the next instruction
+  emit(OP_JPC, 0, 0);
+  return cx - 1;
+}
+
+//Function to set the target instruction index
+static inline void set_target(int instr_index, int target_instr_index) {
+  codebuf[instr_index].m = WA(target_instr_index);
+  stats.backpatches++;
+}
+
+//Function to emit the JMP opcode to jump to the target instruction index
+static inline void emit_jmp_to(int target_instr_index) {
+  emit(OP_JMP, 0, WA(target_instr_index));
+}
+
+//Function to find the live procedure whose code starts at an instruction index
+static int proc_at(int entry) {
+  for (int p = 0; p < procCount; p++) {
+    if (!proc_table[p].dead && proc_table[p].entry == entry) return p;
+  }
+  return -1;
 }
 
+//Function to tell whether instruction i is code of a procedure nested in p,
+//which is emitted inside p's entry..end range
+static int in_nested(int p, int i) {
+  for (int q = 0; q < procCount; q++) {
+    procinfo *nested = &proc_table[q];
+    if (nested->parent == p && q != p && !nested->dead && i >= nested->entry && i <= nested->end) return 1;
+  }
+  return 0;
+}
+
+//Function to tell whether the calls in q's finished code can lead to p.
+//A procedure still being compiled may call anything, so it counts as a path.
+static int calls_reach(int q, int p, char *seen) {
+  procinfo *proc = &proc_table[q];
+  if (proc->end < 0) return 1;
+  seen[q] = 1;
+  for (int i = proc->entry; i <= proc->end; i++) {
+    if ((codebuf[i].op != OP_CAL && codebuf[i].op != OP_TCL) || in_nested(q, i)) continue;
+    int r = proc_at(codebuf[i].m / 3);
+    if (r == p || (r >= 0 && !seen[r] && calls_reach(r, p, seen))) return 1;
+  }
+  return 0;
+}
+
+//Function to copy a small procedure's body to the call site instead of calling it.
+//The callee's own variables move into scratch cells of the caller's frame and
+//its outer references are re-leveled for the caller's depth.
+static int try_inline(int p) {
+  procinfo *callee = &proc_table[p];
+
+  //end < 0 means the callee is still being compiled, so this call is recursive;
+  //a finished callee is recursive if its calls lead back to it
+  if (!optimize || callee->end < 0 || callee->hasNested) return 0;
+  static char seen[MAX_PROCS];
+  memset(seen, 0, sizeof(seen));
+  if (calls_reach(p, p, seen)) return 0;
+
+  int first = callee->incIdx + 1;
+  int size = callee->end - first;
+  if (size > INLINE_MAX_INSTRS || cx + size > MAX_CODE_LENGTH) return 0;
+
+  procinfo *caller = &proc_table[curProc];
+  int delta = level - callee->level;        // caller level minus callee's block level
+  int scratchBase = 3 + caller->nvars + caller->temps;  // first cell after the caller's variables and temps
+  int cells = codebuf[callee->incIdx].m - 3;
+  if (cells > caller->scratch) caller->scratch = cells;
+
+  int start = cx;
+  for (int i = first; i < callee->end; i++) {
+    instruction in = codebuf[i];
+    switch (in.op) {
+      case OP_LOD: case OP_STO:
+        if (in.l == 0) in.m = scratchBase + (in.m - 3);
+        else in.l += delta;
+        break;
+      case OP_CAL:
+        in.l += delta;
+        break;
+      case OP_JMP: case OP_JPC:
+        //A jump to the callee's RTN lands just past the inlined body
+        in.m = WA(start + (in.m / 3 - first));
+        break;
+    }
+    emit(in.op, in.l, in.m);
+    codeLine[cx - 1] = codeLine[i];   // profiles point at the callee's source
+  }
+  return 1;
+}
+
+//Function to generate the code of an expression or condition
+static void gen_expr(node *n) {
+  switch (n->kind) {
+    case N_NUM: genLine = n->line; emit(OP_LIT, 0, n->m); break;
+    case N_VAR: genLine = n->line; emit(OP_LOD, n->l, n->m); break;
+    case N_BIN:
+      gen_expr(n->a);
+      if (n->b) gen_expr(n->b);
+      genLine = n->line;
+      emit(OP_OPR, 0, n->op);
+      break;
+  }
+}
+
+//Function to generate the code of a statement
+static void gen_stmt(node *n) {
+  switch (n->kind) {
+    case N_ASSIGN:
+      gen_expr(n->a);
+      genLine = n->line;
+      emit(OP_STO, n->l, n->m);
+      break;
+    case N_CALL:
+      genLine = n->line;
+      if (!try_inline(n->m)) emit(OP_CAL, n->l, WA(proc_table[n->m].entry));
+      break;
+    case N_SEQ:
+      for (node *s = n->a; s; s = s->next) gen_stmt(s);
+      break;
+    case N_IF: {
+      gen_expr(n->a);
+      genLine = n->line;
+      int jpcIdx = emit_jpc_placeholder();  /* JPC 0 ? */
+      gen_stmt(n->b);
+      set_target(jpcIdx, cx);               /* backpatch to next instr */
+      break;
+    }
+    case N_WHILE: {
+      int loopStart = cx;
+      gen_expr(n->a);
+      genLine = n->line;
+      int jpcIdx = emit_jpc_placeholder();
+      gen_stmt(n->b);
+      genLine = n->line;
+      emit_jmp_to(loopStart);
+      set_target(jpcIdx, cx);
+      break;
+    }
+    case N_READ:
+      genLine = n->line;
+      emit(OP_SYS, 0, 2);                         /* read int */
+      emit(OP_STO, n->l, n->m);                   /* store */
+      break;
+    case N_WRITE:
+      gen_expr(n->a);
+      genLine = n->line;
+      emit(OP_SYS, 0, 1);                         /* write */
+      break;
+  }
+}
+
+//Function to generate a procedure's block: its nested procedures behind a
+//JMP, then INC and the body. Procedures are generated before their callers,
+//so try_inline() sees every non-recursive callee's finished code.
+static void gen_block(node *n) {
+  int p = n->m;
+  procinfo *proc = &proc_table[p];
+  int savedProc = curProc, savedLevel = level;
+  curProc = p;
+  level = proc->level;
+  proc->entry = cx;
+  if (n->l >= 0) symbol_table[n->l].addr = WA(cx);
+
+  //Jump over the code of nested procedures to this block's INC
+  genLine = n->line;
+  int jmpIdx = cx;
+  emit(OP_JMP, 0, 0);
+  for (node *q = n->b; q; q = q->next) {
+    gen_block(q);
+    //Return from the procedure
+    genLine = q->line;
+    proc_table[q->m].end = cx;
+    emit(OP_OPR, 0, 0);
+  }
+
+  //The main block always keeps its JMP; a procedure only needs one to skip nested code
+  if (!proc->hasNested && level > 0) cx--;
+  else { codebuf[jmpIdx].m = WA(cx); stats.backpatches++; }
+
+  //Function to reserve stack space: 3 + nvars + temps (+ inlined callees' variables, patched below)
+  genLine = n->line;
+  proc->incIdx = cx;
+  emit(OP_INC, 0, 3 + proc->nvars + proc->temps);
+
+  gen_stmt(n->a);
+  codebuf[proc->incIdx].m += proc->scratch;
+
+  curProc = savedProc;
+  level = savedLevel;
+}
 
 //Token File Loader
 static void load_tokens_or_die(void) 
@@ -653,47 +1131,931 @@ static void load_tokens_or_die(void)
   Our lex.c file outputs with lexeme table and then token list.
   Input for parsercodegen.c must be the token list only.
    */
+  static int32_t type[MAX_TOKENS], val[MAX_TOKENS];
+  static char names[MAX_TOKENS * 64];
   FILE *fp = fopen("tokens.txt", "r");
   if (!fp) { printf("Error: tokens.txt not found.\n"); exit(1); }
 
-  //Set the token count to 0 as we start loading the tokens
+  //Set the token count to 0 as we start loading the tokens; names offset 0 is ""
   tokCount = 0;
+  tokStrBytes = 1;
 
   //Loop to load the tokens
   while (tokCount < MAX_TOKENS) 
   {
     int ty;
+    char lexeme[64];
     //If the end of the tokens is not found, break the loop
     if (fscanf(fp, "%d", &ty) != 1) break; 
 
-    //Set the token type
-    tokens[tokCount].type = ty;
-    //Set the token hasLexeme to 0
-    tokens[tokCount].hasLexeme = 0;
-    //Set the token lexeme to an empty string
-    tokens[tokCount].lexeme[0] = '\0';
-
-    //If the token type is identsym or numbersym, set the token hasLexeme to 1
-    if (ty == identsym || ty == numbersym) {
-      //If the token lexeme is found, set the token hasLexeme to 1
-      if (fscanf(fp, "%s", tokens[tokCount].lexeme) == 1) {
-        tokens[tokCount].hasLexeme = 1;
+    //Set the token type, with no value or name yet
+    type[tokCount] = ty;
+    val[tokCount] = 0;
+
+    //If the token type is identsym or numbersym, decode its lexeme
+    if ((ty == identsym || ty == numbersym) && fscanf(fp, "%63s", lexeme) == 1) {
+      if (ty == numbersym) val[tokCount] = atoi(lexeme);
+      else {
+        val[tokCount] = tokStrBytes;
+        strcpy(names + tokStrBytes, lexeme);
+        tokStrBytes += strlen(lexeme) + 1;
       }
     }
     //Increment the token count
     tokCount++;
   }
   //Close the file
+  phases[PH_TOKEN_LOAD].bytes = ftell(fp);
+  fclose(fp);
+  tokType = type; tokVal = val; tokStr = names;
+}
+
+//Function to map tokens.bin (./lex -b); the arrays are used in place, nothing is parsed
+static void map_tokens_or_die(void)
+{
+  int fd = open("tokens.bin", O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) { printf("Error: tokens.bin not found.\n"); exit(1); }
+  const char *map = NULL;
+  if (st.st_size > 0) {
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) map = NULL;
+  }
+  close(fd);
+
+  //The section sizes must add up to the file size and the string table must end in a NUL
+  const pm0tokens_header *h = (const pm0tokens_header *)map;
+  if (!map || (size_t)st.st_size < sizeof(*h) || memcmp(h->magic, PM0TOKENS_MAGIC, sizeof(h->magic)) != 0 ||
+      h->version != PM0TOKENS_VERSION || h->count < 0 || h->strBytes < 0 ||
+      (size_t)st.st_size != sizeof(*h) + 2 * (size_t)h->count * sizeof(int32_t) + (size_t)h->strBytes ||
+      (h->strBytes > 0 && map[st.st_size - 1] != '\0')) {
+    printf("Error: tokens.bin is not a token file.\n");
+    exit(1);
+  }
+  tokType = (const int32_t *)(map + sizeof(*h));
+  tokVal = tokType + h->count;
+  tokStr = (const char *)(tokVal + h->count);
+  tokStrBytes = h->strBytes;
+  tokCount = (h->count < MAX_TOKENS) ? h->count : MAX_TOKENS;
+  phases[PH_TOKEN_LOAD].bytes = (long)st.st_size;
+}
+
+//Function to follow a chain of unconditional jumps from an instruction index
+static int follow_jumps(int i) {
+  //Bounded so a jump cycle cannot hang the compiler
+  for (int hops = 0; hops < cx && i < cx && codebuf[i].op == OP_JMP; hops++) {
+    i = codebuf[i].m / 3;
+  }
+  return i;
+}
+
+//Tail-call pass: a CAL whose next executed instruction is RTN becomes TCL,
+//which reuses the caller's AR instead of pushing a new one.
+//Only L >= 1 qualifies; with L = 0 the callee's static link is the
+//caller's own AR, which must stay alive.
+static int tail_call_pass(void) {
+  int changed = 0;
+  for (int i = 0; i + 1 < cx; i++) {
+    if (codebuf[i].op != OP_CAL || codebuf[i].l < 1) continue;
+    int next = follow_jumps(i + 1);
+    if (next < cx && codebuf[next].op == OP_OPR && codebuf[next].m == 0) {
+      codebuf[i].op = OP_TCL;
+      changed = 1;
+    }
+  }
+  return changed;
+}
+
+//Per-instruction scratch flags for the -O passes
+static char keep[MAX_CODE_LENGTH];
+static char isTarget[MAX_CODE_LENGTH + 1];
+static int newIndex[MAX_CODE_LENGTH + 1];
+
+//Function to mark every instruction index that some jump or call lands on
+static void find_targets(void) {
+  memset(isTarget, 0, sizeof(isTarget));
+  for (int i = 0; i < cx; i++) {
+    int op = codebuf[i].op;
+    if (op == OP_JMP || op == OP_JPC || op == OP_CAL || op == OP_TCL) {
+      int target = codebuf[i].m / 3;
+      if (target >= 0 && target <= cx) isTarget[target] = 1;
+    }
+  }
+}
+
+//Function to drop every instruction with keep[i] == 0 and retarget the rest.
+//A jump to a removed instruction lands on the next instruction that is kept.
+static void compact_code(void) {
+  int n = 0;
+  for (int i = 0; i < cx; i++) {
+    if (keep[i]) newIndex[i] = n++;
+  }
+  newIndex[cx] = n;
+  for (int i = cx - 1; i >= 0; i--) {
+    if (!keep[i]) newIndex[i] = newIndex[i + 1];
+  }
+
+  for (int i = 0; i < cx; i++) {
+    if (!keep[i]) continue;
+    instruction in = codebuf[i];
+    if (in.op == OP_JMP || in.op == OP_JPC || in.op == OP_CAL || in.op == OP_TCL) {
+      in.m = WA(newIndex[in.m / 3]);
+    }
+    codebuf[newIndex[i]] = in;
+    codeLine[newIndex[i]] = codeLine[i];
+  }
+
+  for (int p = 0; p < procCount; p++) {
+    if (!proc_table[p].dead && !keep[proc_table[p].incIdx]) proc_table[p].dead = 1;
+    proc_table[p].entry = newIndex[proc_table[p].entry];
+    proc_table[p].incIdx = newIndex[proc_table[p].incIdx];
+    proc_table[p].end = newIndex[proc_table[p].end];
+  }
+  for (int i = 0; i < symCount; i++) {
+    if (symbol_table[i].kind == 3) symbol_table[i].addr = WA(newIndex[symbol_table[i].addr / 3]);
+  }
+  cx = n;
+  memset(keep, 1, sizeof(keep));
+}
+
+//Function to evaluate a binary OPR on two constants; returns 0 if it must stay at run time
+static int fold_opr(int m, int a, int b, int *result) {
+  unsigned int ua = (unsigned int)a, ub = (unsigned int)b;
+  switch (m) {
+    case OPR_ADD: *result = (int)(ua + ub); return 1;
+    case OPR_SUB: *result = (int)(ua - ub); return 1;
+    case OPR_MUL: *result = (int)(ua * ub); return 1;
+    case OPR_DIV:
+      if (b == 0 || (a == -2147483647 - 1 && b == -1)) return 0;
+      *result = a / b; return 1;
+    case OPR_EQL: *result = (a == b); return 1;
+    case OPR_NEQ: *result = (a != b); return 1;
+    case OPR_LSS: *result = (a < b); return 1;
+    case OPR_LEQ: *result = (a <= b); return 1;
+    case OPR_GTR: *result = (a > b); return 1;
+    case OPR_GEQ: *result = (a >= b); return 1;
+  }
+  return 0;
+}
+
+//Constant folding: LIT LIT OPR and LIT OPR 11 become one LIT, a constant JPC
+//becomes a JMP or disappears, and a JMP to the next instruction is dropped.
+//No instruction after the first of a pattern may be a jump target.
+static int fold_constants(void) {
+  int changed = 0;
+  find_targets();
+  memset(keep, 1, sizeof(keep));
+  for (int i = 0; i < cx; i++) {
+    instruction *c = &codebuf[i];
+    int result;
+    if (c[0].op == OP_JMP && c[0].m == WA(i + 1)) {
+      keep[i] = 0;
+    } else if (i + 2 < cx && c[0].op == OP_LIT && c[1].op == OP_LIT && c[2].op == OP_OPR &&
+               !isTarget[i + 1] && !isTarget[i + 2] && fold_opr(c[2].m, c[0].m, c[1].m, &result)) {
+      c[0].m = result;
+      keep[i + 1] = keep[i + 2] = 0;
+      i += 2;
+    } else if (i + 1 < cx && c[0].op == OP_LIT && c[1].op == OP_OPR && c[1].m == OPR_ODD && !isTarget[i + 1]) {
+      c[0].m = (c[0].m % 2 == 0);  // the VM's OPR 11 is EVEN
+      keep[i + 1] = 0;
+      i += 1;
+    } else if (i + 1 < cx && c[0].op == OP_LIT && c[1].op == OP_JPC && !isTarget[i + 1]) {
+      if (c[0].m == 0) { c[0].op = OP_JMP; c[0].l = 0; c[0].m = c[1].m; }
+      else keep[i] = 0;
+      keep[i + 1] = 0;
+      i += 1;
+    } else {
+      continue;
+    }
+    changed = 1;
+  }
+  if (changed) compact_code();
+  return changed;
+}
+
+//Function to remove instructions no path from the program entry reaches,
+//including whole procedures that are never called (e.g. fully inlined)
+static int remove_unreachable(void) {
+  static char reached[MAX_CODE_LENGTH];
+  static int work[MAX_CODE_LENGTH];
+  int top = 0;
+  memset(reached, 0, sizeof(reached));
+  reached[0] = 1; work[top++] = 0;
+  while (top > 0) {
+    int i = work[--top];
+    instruction in = codebuf[i];
+    int succ[2], ns = 0;
+    if (in.op == OP_JMP || in.op == OP_TCL) succ[ns++] = in.m / 3;
+    else if (in.op == OP_JPC || in.op == OP_CAL) { succ[ns++] = i + 1; succ[ns++] = in.m / 3; }
+    else if (!(in.op == OP_OPR && in.m == 0) && !(in.op == OP_SYS && in.m == 3)) succ[ns++] = i + 1;
+    for (int k = 0; k < ns; k++) {
+      if (succ[k] >= 0 && succ[k] < cx && !reached[succ[k]]) { reached[succ[k]] = 1; work[top++] = succ[k]; }
+    }
+  }
+  int changed = 0;
+  for (int i = 0; i < cx; i++) {
+    keep[i] = reached[i];
+    if (!reached[i]) changed = 1;
+  }
+  compact_code();
+  return changed;
+}
+
+//Function to map each instruction to the procedure whose block owns it
+static void find_owners(int *owner) {
+  for (int i = 0; i < cx; i++) owner[i] = -1;
+  for (int p = 0; p < procCount; p++) {
+    if (proc_table[p].dead) continue;
+    owner[proc_table[p].entry] = p;
+    for (int i = proc_table[p].incIdx; i <= proc_table[p].end && i < cx; i++) owner[i] = p;
+  }
+}
+
+//Function to find the procedure whose AR a LOD/STO in procedure p reaches with level difference l
+static int frame_of(int p, int l) {
+  while (l-- > 0 && p >= 0) p = proc_table[p].parent;
+  return p;
+}
+
+//Function to find the first instruction of the pure expression feeding the STO at index sto,
+//or -1 if it reads input, crosses a jump target or is not straight-line
+static int expression_start(int sto) {
+  int need = 1;
+  int j = sto;
+  if (isTarget[sto]) return -1;
+  while (need > 0) {
+    if (--j < 0) return -1;
+    instruction in = codebuf[j];
+    if (in.op == OP_LIT || in.op == OP_LOD) need--;
+    else if (in.op == OP_OPR && in.m >= OPR_ADD && in.m <= OPR_GEQ) need++;
+    else if (!(in.op == OP_OPR && in.m == OPR_ODD)) return -1;
+    if (need > 0 && isTarget[j]) return -1;
+  }
+  return j;
+}
+
+//Dead-variable pass: stores to variables that are never loaded are removed
+//with their expressions, then each frame is renumbered densely from offset 3
+//and its INC shrunk to match. A `read` into an unused variable keeps its store.
+static int remove_dead_variables(void) {
+  static int owner[MAX_CODE_LENGTH];
+  static char loaded[MAX_PROCS][MAX_SYMBOL_TABLE_SIZE + 3];
+  static int remap[MAX_SYMBOL_TABLE_SIZE + 3];
+  int frameLimit = MAX_SYMBOL_TABLE_SIZE + 3;
+
+  int removed = 0;
+
+  //Removing a store can leave its operands' variables unloaded, so repeat
+  for (int changed = 1; changed; ) {
+    changed = 0;
+    find_owners(owner);
+    find_targets();
+    memset(loaded, 0, sizeof(loaded));
+    for (int i = 0; i < cx; i++) {
+      if (codebuf[i].op != OP_LOD || owner[i] < 0) continue;
+      int f = frame_of(owner[i], codebuf[i].l);
+      if (f >= 0 && codebuf[i].m < frameLimit) loaded[f][codebuf[i].m] = 1;
+    }
+    memset(keep, 1, sizeof(keep));
+    for (int i = 0; i < cx; i++) {
+      if (codebuf[i].op != OP_STO || owner[i] < 0) continue;
+      int f = frame_of(owner[i], codebuf[i].l);
+      if (f < 0 || codebuf[i].m >= frameLimit || loaded[f][codebuf[i].m]) continue;
+      int start = expression_start(i);
+      if (start < 0) continue;
+      for (int j = start; j <= i; j++) keep[j] = 0;
+      changed = 1;
+    }
+    if (changed) compact_code();
+    removed |= changed;
+  }
+
+  //Renumber each frame's remaining variables and shrink its INC
+  find_owners(owner);
+  for (int p = 0; p < procCount; p++) {
+    if (proc_table[p].dead) continue;
+    int size = codebuf[proc_table[p].incIdx].m;
+    if (size > frameLimit) continue;
+    memset(remap, 0, sizeof(remap));
+    for (int i = 0; i < cx; i++) {
+      if ((codebuf[i].op == OP_LOD || codebuf[i].op == OP_STO) && owner[i] >= 0 &&
+          frame_of(owner[i], codebuf[i].l) == p && codebuf[i].m < size) {
+        remap[codebuf[i].m] = 1;
+      }
+    }
+    int next = 3;
+    for (int off = 3; off < size; off++) {
+      if (remap[off]) remap[off] = next++;
+    }
+    for (int i = 0; i < cx; i++) {
+      if ((codebuf[i].op == OP_LOD || codebuf[i].op == OP_STO) && owner[i] >= 0 &&
+          frame_of(owner[i], codebuf[i].l) == p && codebuf[i].m >= 3 && codebuf[i].m < size) {
+        codebuf[i].m = remap[codebuf[i].m];
+      }
+    }
+    if (codebuf[proc_table[p].incIdx].m != next) removed = 1;
+    codebuf[proc_table[p].incIdx].m = next;
+  }
+  return removed;
+}
+
+//Function to walk one procedure's code and record its frame size and the
+//deepest operand stack above it. Depth only depends on the instructions
+//emitted by expression(), term(), condition() and the block's INC.
+static void measure_proc(int p) {
+  static int depth[MAX_CODE_LENGTH];
+  static int work[MAX_CODE_LENGTH];
+  procinfo *proc = &proc_table[p];
+  int top = 0, deepest = 0;
+  for (int i = 0; i < cx; i++) depth[i] = -1;
+  depth[proc->entry] = 0;
+  work[top++] = proc->entry;
+  while (top > 0) {
+    int i = work[--top];
+    instruction in = codebuf[i];
+    int d = depth[i], nd = d, succ[2], ns = 0;
+    switch (in.op) {
+      case OP_LIT: case OP_LOD: nd = d + 1; succ[ns++] = i + 1; break;
+      case OP_STO: nd = d - 1; succ[ns++] = i + 1; break;
+      case OP_OPR:
+        if (in.m == 0) break;                                  // RTN
+        nd = (in.m == OPR_ODD) ? d : d - 1; succ[ns++] = i + 1;
+        break;
+      case OP_INC: nd = d + in.m; succ[ns++] = i + 1; break;
+      case OP_JMP: succ[ns++] = in.m / 3; break;
+      case OP_JPC: nd = d - 1; succ[ns++] = i + 1; succ[ns++] = in.m / 3; break;
+      case OP_CAL: succ[ns++] = i + 1; break;
+      case OP_TCL: break;
+      case OP_SYS:
+        if (in.m == 1) nd = d - 1;
+        else if (in.m == 2) nd = d + 1;
+        if (in.m != 3) succ[ns++] = i + 1;
+        break;
+    }
+    if (nd > deepest) deepest = nd;
+    for (int k = 0; k < ns; k++) {
+      if (succ[k] < cx && depth[succ[k]] < 0) { depth[succ[k]] = nd; work[top++] = succ[k]; }
+    }
+  }
+  proc->frame = codebuf[proc->incIdx].m;
+  proc->maxOps = deepest - proc->frame;
+  if (proc->maxOps < 0) proc->maxOps = 0;
+}
+
+//Function to compute the worst-case stack cells a call to p can use:
+//its frame and operands, or the deepest CAL point plus the callee's need.
+//A TCL callee replaces p's frame. Recursion (other than a direct tail
+//call to itself) makes the need unbounded (-1).
+static int stack_need(int p) {
+  procinfo *proc = &proc_table[p];
+  if (proc->state == 2) return proc->need;
+  if (proc->state == 1) return -1;
+  proc->state = 1;
+  int need = proc->frame + proc->maxOps;
+  for (int i = proc->entry; i <= proc->end && need >= 0; i++) {
+    int op = codebuf[i].op;
+    //Calls in nested procedures' code are theirs, not p's
+    if ((op != OP_CAL && op != OP_TCL) || in_nested(p, i)) continue;
+    int q = proc_at(codebuf[i].m / 3);
+    if (q < 0) continue;
+    if (op == OP_TCL && q == p) continue;
+    int sub = stack_need(q);
+    if (sub < 0) { need = -1; break; }
+    //Calls are statements, so the operand stack is empty at a CAL
+    int total = (op == OP_CAL) ? proc->frame + sub : sub;
+    if (total > need) need = total;
+  }
+  proc->need = need;
+  proc->state = 2;
+  return need;
+}
+
+//Function to fill in frame, operand depth and stack need for every live procedure
+static int analyze_stack(void) {
+  for (int p = 0; p < procCount; p++) {
+    proc_table[p].state = 0;
+    if (!proc_table[p].dead) measure_proc(p);
+  }
+  for (int p = 0; p < procCount; p++) {
+    if (!proc_table[p].dead) stack_need(p);
+  }
+  return 0;
+}
+
+//AST constant folding: operators on constants become N_NUM, an if with a
+//constant condition becomes its branch or nothing, and a while that never
+//runs disappears. Statements are rewritten in place so sequences stay linked.
+static int fold_node(node *n) {
+  int changed = 0;
+  if (!n) return 0;
+  switch (n->kind) {
+    case N_BIN: {
+      changed |= fold_node(n->a);
+      changed |= fold_node(n->b);
+      int result;
+      if (n->op == OPR_ODD && n->a->kind == N_NUM) {
+        result = (n->a->m % 2 == 0);  // the VM's OPR 11 is EVEN
+      } else if (n->op == OPR_ODD || n->a->kind != N_NUM || n->b->kind != N_NUM ||
+                 !fold_opr(n->op, n->a->m, n->b->m, &result)) {
+        break;
+      }
+      n->kind = N_NUM; n->m = result;
+      n->a = n->b = NULL;
+      changed = 1;
+      break;
+    }
+    case N_ASSIGN: case N_WRITE:
+      changed |= fold_node(n->a);
+      break;
+    case N_SEQ:
+      for (node *s = n->a; s; s = s->next) changed |= fold_node(s);
+      break;
+    case N_IF: case N_WHILE:
+      changed |= fold_node(n->a);
+      changed |= fold_node(n->b);
+      if (n->a->kind != N_NUM) break;
+      if (n->a->m == 0) {
+        n->kind = N_EMPTY;
+        n->a = n->b = NULL;
+        changed = 1;
+      } else if (n->kind == N_IF) {
+        node *next = n->next;
+        *n = *n->b;
+        n->next = next;
+        changed = 1;
+      }
+      break;
+    case N_PROC:
+      for (node *q = n->b; q; q = q->next) changed |= fold_node(q);
+      changed |= fold_node(n->a);
+      break;
+  }
+  return changed;
+}
+
+//Loop-invariant code motion: an operator subtree of a while loop's condition
+//or body that only reads variables the loop never stores to is computed once
+//into a frame temporary before the loop head and read from there instead.
+//A loop stores to its assigned and read variables and, through calls, to
+//everything the callees may store to (procMods, closed over the call graph).
+static node *procNode[MAX_PROCS];
+static int varBase[MAX_PROCS];  // first global variable number of each frame
+static char procMods[MAX_PROCS][MAX_SYMBOL_TABLE_SIZE];
+
+#define MAX_HOISTED 64  // per loop
+
+//Function to number a variable program-wide from its use in procedure p, -1 for temporaries
+static int var_index(int p, int l, int m) {
+  for (; l > 0 && p >= 0; l--) p = proc_table[p].parent;
+  if (p < 0 || m < 3 || m >= 3 + proc_table[p].nvars) return -1;
+  return varBase[p] + m - 3;
+}
+
+//Function to record the N_PROC node of every procedure
+static void find_proc_nodes(node *n) {
+  procNode[n->m] = n;
+  for (node *q = n->b; q; q = q->next) find_proc_nodes(q);
+}
+
+//Function to mark the variables a statement of procedure p may store to; returns 1 if any were new
+static int collect_mods(node *n, int p, char *mods) {
+  int changed = 0;
+  if (!n) return 0;
+  switch (n->kind) {
+    case N_ASSIGN: case N_READ: {
+      int v = var_index(p, n->l, n->m);
+      if (v >= 0 && !mods[v]) { mods[v] = 1; changed = 1; }
+      break;
+    }
+    case N_CALL:
+      for (int v = 0; v < MAX_SYMBOL_TABLE_SIZE; v++) {
+        if (procMods[n->m][v] && !mods[v]) { mods[v] = 1; changed = 1; }
+      }
+      break;
+    case N_SEQ:
+      for (node *s = n->a; s; s = s->next) changed |= collect_mods(s, p, mods);
+      break;
+    case N_IF: case N_WHILE:
+      changed |= collect_mods(n->b, p, mods);
+      break;
+  }
+  return changed;
+}
+
+//Function to check that an expression reads no variable in mods. Unless it
+//always runs (the loop condition), a division must also be unable to trap.
+static int is_invariant(node *e, int p, const char *mods, int always) {
+  switch (e->kind) {
+    case N_NUM: return 1;
+    case N_VAR: {
+      int v = var_index(p, e->l, e->m);
+      return v >= 0 && !mods[v];
+    }
+    case N_BIN:
+      if (e->op == OPR_DIV && !always && (e->b->kind != N_NUM || e->b->m == 0 || e->b->m == -1)) return 0;
+      return is_invariant(e->a, p, mods, always) && (!e->b || is_invariant(e->b, p, mods, always));
+  }
+  return 0;
+}
+
+//Function to compare two expressions structurally
+static int same_expr(node *x, node *y) {
+  if (!x || !y) return x == y;
+  if (x->kind != y->kind || x->op != y->op || x->l != y->l || x->m != y->m) return 0;
+  return same_expr(x->a, y->a) && same_expr(x->b, y->b);
+}
+
+//Function to replace the largest invariant operator subtrees of an expression
+//with temporaries, adding an assignment per distinct subtree to hoisted
+static int hoist_expr(node *e, int p, const char *mods, int always, node **hoisted, int *nh) {
+  if (e->kind != N_BIN) return 0;
+  if (!is_invariant(e, p, mods, always)) {
+    int changed = hoist_expr(e->a, p, mods, always, hoisted, nh);
+    if (e->b) changed |= hoist_expr(e->b, p, mods, always, hoisted, nh);
+    return changed;
+  }
+  int k = 0;
+  while (k < *nh && !same_expr(hoisted[k]->a, e)) k++;
+  if (k == *nh) {
+    if (*nh >= MAX_HOISTED || nodeCount + 3 > MAX_NODES) return 0;
+    procinfo *proc = &proc_table[p];
+    node *copy = new_node(N_BIN, e->line);
+    *copy = *e;
+    hoisted[k] = new_node(N_ASSIGN, e->line);
+    hoisted[k]->m = 3 + proc->nvars + proc->temps++;
+    hoisted[k]->a = copy;
+    (*nh)++;
+  }
+  e->kind = N_VAR; e->op = 0;
+  e->l = 0; e->m = hoisted[k]->m;
+  e->a = e->b = NULL;
+  return 1;
+}
+
+//Function to hoist from every expression of a loop body
+static int hoist_stmt(node *n, int p, const char *mods, node **hoisted, int *nh) {
+  int changed = 0;
+  if (!n) return 0;
+  switch (n->kind) {
+    case N_ASSIGN: case N_WRITE:
+      changed |= hoist_expr(n->a, p, mods, 0, hoisted, nh);
+      break;
+    case N_SEQ:
+      for (node *s = n->a; s; s = s->next) changed |= hoist_stmt(s, p, mods, hoisted, nh);
+      break;
+    case N_IF: case N_WHILE:
+      changed |= hoist_expr(n->a, p, mods, 0, hoisted, nh);
+      changed |= hoist_stmt(n->b, p, mods, hoisted, nh);
+      break;
+  }
+  return changed;
+}
+
+//Function to run LICM on the loops of a statement, outer loops first so an
+//expression leaves every loop it is invariant in. A while that hoists becomes
+//begin T1 := e1; ...; while ... end, rewritten in place to keep the sequence linked.
+static int licm_stmt(node *n, int p) {
+  int changed = 0;
+  if (!n) return 0;
+  switch (n->kind) {
+    case N_SEQ:
+      for (node *s = n->a; s; s = s->next) changed |= licm_stmt(s, p);
+      break;
+    case N_IF:
+      changed |= licm_stmt(n->b, p);
+      break;
+    case N_WHILE: {
+      static char mods[MAX_SYMBOL_TABLE_SIZE];
+      node *hoisted[MAX_HOISTED];
+      int nh = 0;
+      memset(mods, 0, sizeof(mods));
+      collect_mods(n, p, mods);
+      hoist_expr(n->a, p, mods, 1, hoisted, &nh);
+      hoist_stmt(n->b, p, mods, hoisted, &nh);
+      if (nh > 0) {
+        node *loop = new_node(N_WHILE, n->line);
+        *loop = *n;
+        loop->next = NULL;
+        for (int k = 0; k + 1 < nh; k++) hoisted[k]->next = hoisted[k + 1];
+        hoisted[nh - 1]->next = loop;
+        n->kind = N_SEQ;
+        n->a = hoisted[0];
+        n->b = NULL;
+        n = loop;
+        changed = 1;
+      }
+      changed |= licm_stmt(n->b, p);
+      break;
+    }
+  }
+  return changed;
+}
+
+//Function to run LICM over every procedure
+static int licm_pass(void) {
+  int changed = 0;
+  memset(procNode, 0, sizeof(procNode));
+  find_proc_nodes(astRoot);
+  for (int p = 0, next = 0; p < procCount; p++) {
+    varBase[p] = next;
+    next += proc_table[p].nvars;
+  }
+  //Each procedure may store to what its callees store to; iterate to cover recursion
+  memset(procMods, 0, sizeof(procMods));
+  for (int grew = 1; grew; ) {
+    grew = 0;
+    for (int p = 0; p < procCount; p++) {
+      if (procNode[p]) grew |= collect_mods(procNode[p]->a, p, procMods[p]);
+    }
+  }
+  for (int p = 0; p < procCount; p++) {
+    if (procNode[p]) changed |= licm_stmt(procNode[p]->a, p);
+  }
+  return changed;
+}
+
+//Function to print an AST node and its children, indented by depth
+static void dump_node(FILE *out, node *n, int depth) {
+  static const char *oprName[] = {"RTN", "ADD", "SUB", "MUL", "DIV", "EQL", "NEQ", "LSS", "LEQ", "GTR", "GEQ", "EVEN"};
+  if (!n) return;
+  fprintf(out, "%*s", 2 * depth, "");
+  switch (n->kind) {
+    case N_NUM: fprintf(out, "num %d\n", n->m); break;
+    case N_VAR: fprintf(out, "var %d %d\n", n->l, n->m); break;
+    case N_BIN:
+      fprintf(out, "%s\n", oprName[n->op]);
+      dump_node(out, n->a, depth + 1);
+      if (n->b) dump_node(out, n->b, depth + 1);
+      break;
+    case N_ASSIGN: fprintf(out, "assign %d %d\n", n->l, n->m); dump_node(out, n->a, depth + 1); break;
+    case N_CALL: fprintf(out, "call %d (level %d)\n", n->m, n->l); break;
+    case N_SEQ:
+      fprintf(out, "begin\n");
+      for (node *s = n->a; s; s = s->next) dump_node(out, s, depth + 1);
+      break;
+    case N_IF: fprintf(out, "if\n"); dump_node(out, n->a, depth + 1); dump_node(out, n->b, depth + 1); break;
+    case N_WHILE: fprintf(out, "while\n"); dump_node(out, n->a, depth + 1); dump_node(out, n->b, depth + 1); break;
+    case N_READ: fprintf(out, "read %d %d\n", n->l, n->m); break;
+    case N_WRITE: fprintf(out, "write\n"); dump_node(out, n->a, depth + 1); break;
+    case N_EMPTY: fprintf(out, "empty\n"); break;
+    case N_PROC:
+      fprintf(out, "proc %d %s (level %d, %d vars)\n", n->m, n->l >= 0 ? symbol_table[n->l].name : "main",
+              proc_table[n->m].level, proc_table[n->m].nvars);
+      for (node *q = n->b; q; q = q->next) dump_node(out, q, depth + 1);
+      dump_node(out, n->a, depth + 1);
+      break;
+  }
+}
+
+//Function to print the current code buffer
+static void dump_code(FILE *out) {
+  for (int i = 0; i < cx; i++) {
+    fprintf(out, "%3d %6s %3d %3d\n", i, op_mnemonic(codebuf[i].op), codebuf[i].l, codebuf[i].m);
+  }
+}
+
+//Mid-level IR of codebuf, kept after each IR pass so --dump-after can print it
+static pm0ir mir;
+static int mirBuilt = 0;
+
+//Function to build the mid-level IR from codebuf
+static int build_mir(void) {
+  static pm0ir_ins in[MAX_CODE_LENGTH];
+  for (int i = 0; i < cx; i++) {
+    memset(&in[i], 0, sizeof(in[i]));
+    in[i].op = codebuf[i].op; in[i].l = codebuf[i].l; in[i].m = codebuf[i].m;
+    in[i].line = codeLine[i];
+  }
+  if (mirBuilt) pm0ir_free(&mir);
+  mirBuilt = pm0ir_build(&mir, in, cx);
+  if (!mirBuilt) pm0ir_free(&mir);
+  return mirBuilt;
+}
+
+//Function to lower the IR back into codebuf and retarget the procedure and symbol tables
+static void lower_mir(void) {
+  static pm0ir_ins out[MAX_CODE_LENGTH];
+  int n = pm0ir_lower(&mir, out, MAX_CODE_LENGTH);
+  if (n < 0) {
+    printf("Error: code array overflow\n");
+    exit(1);
+  }
+  //Instructions the passes removed map to the next one that survives
+  for (int i = 0; i <= cx; i++) newIndex[i] = -1;
+  for (int k = 0; k < n; k++) {
+    if (out[k].orig >= 0) newIndex[out[k].orig] = k;
+  }
+  newIndex[cx] = n;
+  for (int i = cx - 1; i >= 0; i--) {
+    if (newIndex[i] < 0) newIndex[i] = newIndex[i + 1];
+  }
+  for (int k = 0; k < n; k++) {
+    codebuf[k].op = out[k].op; codebuf[k].l = out[k].l; codebuf[k].m = out[k].m;
+    codeLine[k] = out[k].line;
+  }
+  for (int p = 0; p < procCount; p++) {
+    proc_table[p].entry = newIndex[proc_table[p].entry];
+    proc_table[p].incIdx = newIndex[proc_table[p].incIdx];
+    proc_table[p].end = newIndex[proc_table[p].end];
+  }
+  for (int i = 0; i < symCount; i++) {
+    if (symbol_table[i].kind == 3) symbol_table[i].addr = WA(newIndex[symbol_table[i].addr / 3]);
+  }
+  cx = n;
+}
+
+//IR passes: ssa builds the mid-level IR, the passes after it transform it,
+//and lower turns it back into codebuf. Code the IR cannot model is skipped.
+static int ssa_pass(void) { build_mir(); return 0; }
+static int cse_pass(void) { return mirBuilt && pm0ir_local_cse(&mir); }
+static int lower_pass(void) {
+  if (!mirBuilt) return 0;
+  lower_mir();
+  pm0ir_free(&mir);
+  mirBuilt = 0;
+  return 0;
+}
+
+//Pass bodies with the signature the pass manager expects
+static int parse_pass(void) { program(); return 1; }
+static int fold_ast_pass(void) { return fold_node(astRoot); }
+static int codegen_pass(void) {
+  gen_block(astRoot);
+  //Emit the SYS opcode to halt the program
+  proc_table[0].end = cx;
+  emit(OP_SYS, 0, 3);
+  return 1;
+}
+
+//Pass manager: every stage runs through run_pass(), which times it
+//(--time-passes, --stats) and prints the IR it leaves behind (--dump-after)
+#define IR_AST  0
+#define IR_CODE 1
+#define IR_SSA  2
+
+typedef struct {
+  const char *name;
+  int ir;             // what the pass produces: IR_AST, IR_CODE or IR_SSA
+  int (*run)(void);   // returns 1 if it changed anything
+  int runs;
+  double seconds;     // processor time
+  double wall;        // wall time (--stats)
+} pass;
+
+enum { PASS_PARSE, PASS_FOLD_AST, PASS_LICM, PASS_CODEGEN, PASS_FOLD, PASS_UNREACHABLE,
+       PASS_SSA, PASS_CSE, PASS_LOWER, PASS_DEAD_VARS, PASS_TAIL_CALLS, PASS_STACK, PASS_COUNT };
+
+static pass passes[PASS_COUNT] = {
+  {"parse",       IR_AST,  parse_pass, 0, 0, 0},
+  {"fold-ast",    IR_AST,  fold_ast_pass, 0, 0, 0},
+  {"licm",        IR_AST,  licm_pass, 0, 0, 0},
+  {"codegen",     IR_CODE, codegen_pass, 0, 0, 0},
+  {"fold",        IR_CODE, fold_constants, 0, 0, 0},
+  {"unreachable", IR_CODE, remove_unreachable, 0, 0, 0},
+  {"ssa",         IR_SSA,  ssa_pass, 0, 0, 0},
+  {"cse",         IR_SSA,  cse_pass, 0, 0, 0},
+  {"lower",       IR_CODE, lower_pass, 0, 0, 0},
+  {"dead-vars",   IR_CODE, remove_dead_variables, 0, 0, 0},
+  {"tail-calls",  IR_CODE, tail_call_pass, 0, 0, 0},
+  {"stack",       IR_CODE, analyze_stack, 0, 0, 0},
+};
+
+static int timePasses = 0;
+static const char *dumpAfter = NULL;  // pass name or "all"
+
+//Function to run one pass with its timing and dump hooks
+static int run_pass(int id) {
+  pass *ps = &passes[id];
+  clock_t start = clock();
+  double wallStart = wall_now();
+  int changed = ps->run();
+  ps->seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+  ps->wall += wall_now() - wallStart;
+  ps->runs++;
+  if (dumpAfter && (strcmp(dumpAfter, "all") == 0 || strcmp(dumpAfter, ps->name) == 0)) {
+    fprintf(stderr, "*** IR after %s (run %d)%s\n", ps->name, ps->runs, changed ? "" : " - unchanged");
+    if (ps->ir == IR_AST) dump_node(stderr, astRoot, 0);
+    else if (ps->ir == IR_SSA && mirBuilt) pm0ir_dump(&mir, stderr);
+    else dump_code(stderr);
+  }
+  return changed;
+}
+
+//Function to report the time spent in each pass
+static void report_pass_times(void) {
+  double total = 0;
+  fprintf(stderr, "Pass            Runs   Time (ms)\n");
+  for (int i = 0; i < PASS_COUNT; i++) {
+    if (!passes[i].runs) continue;
+    fprintf(stderr, "%-14s %5d %11.3f\n", passes[i].name, passes[i].runs, passes[i].seconds * 1000);
+    total += passes[i].seconds;
+  }
+  fprintf(stderr, "%-14s %5s %11.3f\n", "total", "", total * 1000);
+}
+
+//Function to print the counters a phase or pass keeps (--stats)
+static void phase_counters(FILE *f, int json, const char *name) {
+  const char *fmt = json ? ", \"%s\": %ld" : " %s=%ld";
+  if (strcmp(name, "token-load") == 0) {
+    fprintf(f, fmt, "tokens", (long)tokCount);
+  } else if (strcmp(name, "parse") == 0) {
+    fprintf(f, fmt, "symbols", stats.symbols);
+    fprintf(f, fmt, "lookups", stats.lookups);
+    fprintf(f, fmt, "probes", stats.probes);
+    fprintf(f, fmt, "max_probe", stats.maxProbe);
+  } else if (strcmp(name, "codegen") == 0) {
+    long total = 0;
+    for (int op = 0; op < 16; op++) total += stats.emitted[op];
+    fprintf(f, fmt, "emitted", total);
+    fprintf(f, fmt, "backpatches", stats.backpatches);
+  }
+}
+
+//Function to print one phase or pass that ran (--stats)
+static void stats_row(int json, int *rows, const char *name, int runs, double wall, long bytes) {
+  if (!runs) return;
+  if (json) {
+    fprintf(stderr, "%s{\"name\": \"%s\", \"runs\": %d, \"wall_ms\": %.3f", *rows ? ", " : "", name, runs, wall * 1000);
+    if (bytes >= 0) fprintf(stderr, ", \"bytes\": %ld", bytes);
+    phase_counters(stderr, 1, name);
+    fprintf(stderr, "}");
+  } else {
+    fprintf(stderr, "%-14s %5d %11.3f", name, runs, wall * 1000);
+    if (bytes >= 0) fprintf(stderr, " bytes=%ld", bytes);
+    phase_counters(stderr, 0, name);
+    fprintf(stderr, "\n");
+  }
+  (*rows)++;
+}
+
+//Function to report the wall time and counters of every phase on stderr (--stats, --stats-json)
+static void report_stats(void) {
+  int json = (statsFormat == STATS_JSON), rows = 0;
+  double total = 0;
+  if (json) fprintf(stderr, "{\"tool\": \"parsercodegen\", \"phases\": [");
+  else fprintf(stderr, "Phase           Runs   Wall (ms) Counters\n");
+
+  //Pipeline order: token load and the skipsym check, the passes that ran, then the outputs
+  for (int i = 0; i < PH_COUNT + PASS_COUNT; i++) {
+    if (i >= PH_SKIPSYM + 1 && i < PH_SKIPSYM + 1 + PASS_COUNT) {
+      pass *ps = &passes[i - PH_SKIPSYM - 1];
+      stats_row(json, &rows, ps->name, ps->runs, ps->wall, -1);
+      total += ps->wall;
+    } else {
+      int ph = (i <= PH_SKIPSYM) ? i : i - PASS_COUNT;
+      stats_row(json, &rows, phases[ph].name, phases[ph].runs, phases[ph].wall, phases[ph].bytes);
+      total += phases[ph].wall;
+    }
+  }
+
+  //Instructions emitted, by opcode
+  if (json) fprintf(stderr, "], \"total_ms\": %.3f, \"emitted\": {", total * 1000);
+  else fprintf(stderr, "%-14s %5s %11.3f\nEmitted by opcode:", "total", "", total * 1000);
+  for (int op = 0, first = 1; op < 16; op++) {
+    if (!stats.emitted[op]) continue;
+    if (json) fprintf(stderr, "%s\"%s\": %ld", first ? "" : ", ", op_mnemonic(op), stats.emitted[op]);
+    else fprintf(stderr, " %s %ld", op_mnemonic(op), stats.emitted[op]);
+    first = 0;
+  }
+  fprintf(stderr, json ? "}}\n" : "\n");
+}
+
+//Function to read tokens.pos (one "line column" pair per token, written by ./lex -g)
+static void load_positions_or_die(void)
+{
+  FILE *fp = fopen("tokens.pos", "r");
+  if (!fp) { printf("Error: tokens.pos not found (run ./lex -g).\n"); exit(1); }
+  for (int i = 0; i < tokCount; i++) {
+    if (fscanf(fp, "%d %d", &tokLinePos[i], &tokColPos[i]) != 2) {
+      printf("Error: tokens.pos does not match tokens.txt\n");
+      exit(1);
+    }
+  }
   fclose(fp);
 }
 
+//Function to write elf.dbg: "instruction line" wherever the source line changes
+static void write_debug_info(void)
+{
+  FILE *f = fopen("elf.dbg", "w");
+  if (!f) { printf("Error: could not open elf.dbg for writing\n"); exit(1); }
+  fprintf(f, "# pm0 lines\n");
+  int last = -1;
+  for (int i = 0; i < cx; i++) {
+    if (codeLine[i] != last) fprintf(f, "%d %d\n", i, codeLine[i]);
+    last = codeLine[i];
+  }
+  phases[PH_WRITE_DEBUG].bytes = ftell(f);
+  fclose(f);
+}
+
 //helper function for skipsym
 static int contains_skipsym(void) 
 {
   //Loop to check if the tokens contain skipsym
   for (int i = 0; i < tokCount; i++) {
     //If the token type is skipsym, return 1
-    if (tokens[i].type == skipsym) return 1;
+    if (tokType[i] == skipsym) return 1;
     //If the token type is not skipsym, return 0
   }
 
@@ -702,24 +2064,79 @@ static int contains_skipsym(void)
 }
 
 //Main
-int main(void) 
+int main(int argc, char *argv[]) 
 {
+  //Option flags only; the token file name stays hard-coded
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-O") == 0) optimize = 1;
+    else if (strcmp(argv[i], "-g") == 0) debugInfo = 1;
+    else if (strcmp(argv[i], "--packed") == 0) packedOutput = 1;
+    else if (strcmp(argv[i], "-b") == 0) binaryTokens = 1;
+    else if (strcmp(argv[i], "--time-passes") == 0) timePasses = 1;
+    else if (strcmp(argv[i], "--stats") == 0) statsFormat = STATS_TEXT;
+    else if (strcmp(argv[i], "--stats-json") == 0) statsFormat = STATS_JSON;
+    else if (strcmp(argv[i], "--dump-after") == 0 && i + 1 < argc) dumpAfter = argv[++i];
+    else { printf("Usage: ./parsercodegen [-O] [-g] [-b] [--packed] [--time-passes] [--stats|--stats-json] [--dump-after <pass|all>]\n"); return 1; }
+  }
+
   //Function to load the tokens
-  load_tokens_or_die();
+  double start = wall_now();
+  if (binaryTokens) map_tokens_or_die();
+  else load_tokens_or_die();
+  if (debugInfo) load_positions_or_die();
+  phase_done(PH_TOKEN_LOAD, start);
 
   //If the lexer output contains skipsym (1), stop immediately 
-  if (contains_skipsym()) 
+  start = wall_now();
+  int scanError = contains_skipsym();
+  phase_done(PH_SKIPSYM, start);
+  if (scanError) 
   {
     scanning_error();
   }
 
-  //Function to parse the program
-  program();
+  //Parse the whole program into the AST, optimize it, then generate code
+  run_pass(PASS_PARSE);
+  if (optimize) {
+    run_pass(PASS_FOLD_AST);
+    run_pass(PASS_LICM);
+  }
+  run_pass(PASS_CODEGEN);
+
+  //Optimization passes over the finished code
+  if (optimize) {
+    //Folding exposes unreachable code and removing it exposes jumps to the next instruction
+    for (int changed = 1; changed; ) {
+      changed = run_pass(PASS_FOLD);
+      changed |= run_pass(PASS_UNREACHABLE);
+    }
+    run_pass(PASS_SSA);
+    run_pass(PASS_CSE);
+    run_pass(PASS_LOWER);
+    run_pass(PASS_DEAD_VARS);
+    run_pass(PASS_TAIL_CALLS);
+  }
+
+  //Frame sizes and worst-case stack use for the object header
+  run_pass(PASS_STACK);
+  if (timePasses) report_pass_times();
 
   //Function to write the ELF file .txt
+  start = wall_now();
   write_elf();
+  phase_done(PH_WRITE_ELF, start);
+  start = wall_now();
+  if (packedOutput) write_packed(), phase_done(PH_WRITE_PACKED, start);
+  else remove("elf.bin");   // nor should a stale packed copy be run by mistake
+  start = wall_now();
+  if (debugInfo) write_debug_info(), phase_done(PH_WRITE_DEBUG, start);
+  else remove("elf.dbg");   // a stale table would mislabel this program
 
   //Print Function to the terminal
+  start = wall_now();
   print_code_to_terminal();
+  fflush(stdout);
+  phase_done(PH_LISTING, start);
+  if (statsFormat) report_stats();
   return 0;
 }
@@ -0,0 +1,556 @@
+/*
+PM/0 compile-and-run server
+Serves requests on a Unix domain socket from a pool of long-lived worker
+processes. A request carries a PL/0 program (or object code) and its input;
+the worker compiles and runs it with the code of lex.c, parsercodegen.c and
+vm.c linked in, and streams the program's output and diagnostics back. No
+program is exec'd, and scratch files stay in the worker's own directory.
+Language: C (only)
+To Compile:
+gcc -O2 -std=c11 -pthread -c -Dmain=lex_main -o lex_d.o lex.c
+gcc -O2 -std=c11 -c -Dmain=parsercodegen_main -o parsercodegen_d.o parsercodegen.c
+gcc -O2 -std=c11 -pthread -c -Dmain=vm_main -o vm_d.o vm.c
+gcc -O2 -std=c11 -pthread -o pm0d pm0d.c lex_d.o parsercodegen_d.o vm_d.o
+To Execute:
+./pm0d [-c <workers>] [--max-steps <n>] [--timeout <seconds>] <socket>
+./pm0d --run <socket> [-O] [--object] [--max-steps <n>] [--timeout <seconds>]
+       <program> [<input>]
+where:
+-c          requests served at once (default 4); each worker takes one
+            request at a time and further connections wait in the backlog
+--max-steps server: cap on a request's instructions (default: none)
+--timeout   server: cap on a request's wall-clock time (default 10 seconds)
+--run       client: send <program> (PL/0 source, or elf.txt/elf.bin with
+            --object) and <input> (default: none), print the program's output
+            on stdout and diagnostics on stderr, and exit with its status;
+            -O, --max-steps and --timeout go with the request
+Protocol (one request per connection):
+  request   "PM0 source|object <program bytes> <input bytes> [O] [steps=<n>]
+            [time=<seconds>]\n", then the program, then the input
+  response  "O <n>\n" and n bytes of program output, "E <n>\n" and n bytes
+            of diagnostics, any number of each, then "X <status> <stage>\n":
+            the exit status of the stage that ended the request (lex, compile
+            or run; request when the request itself was bad)
+Notes:
+- Each stage runs in a child forked from the worker, which never runs one
+  itself, so the programs' globals start fresh every time and a stage that
+  calls exit() ends only itself
+- A request can lower the server's step and time caps, not raise them;
+  the VM stops at them as with ./vm --max-steps/--timeout (status 3 or 4)
+  and a stage still running shortly after the deadline is killed (status 4)
+*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+// Entry points of the linked programs (compiled with -Dmain=...)
+int lex_main(int argc, char *argv[]);
+int parsercodegen_main(int argc, char *argv[]);
+int vm_main(int argc, char *argv[]);
+#define MAX_WORKERS 256
+#define MAX_HEADER 256
+#define MAX_PROGRAM (1 << 20)
+#define MAX_INPUT (1 << 24)
+#define MAX_DIAG (1 << 16) // compile diagnostics kept per stage
+#define KILL_GRACE 0.5     // seconds past the deadline before a stage is killed
+// Files a request may leave in the scratch directory
+const char *scratchFiles[] = {"program.pl0", "input", "tokens.bin", "elf.txt", "elf.bin", "elf.dbg"};
+// Server settings
+long long capSteps = 0;
+double capSeconds = 10;
+int listenFd = -1;
+char workDir[64];
+volatile sig_atomic_t stopping = 0;
+void onStop(int sig)
+{
+    (void)sig;
+    stopping = 1;
+}
+// Helper: seconds on the monotonic clock
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+// Helper: send all of buf; returns 0 once the peer is gone
+int sendAll(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+    while (len > 0)
+    {
+        ssize_t w = send(fd, p, len, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return 0;
+        p += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+// Helper: send one response frame
+int sendFrame(int fd, char tag, const char *data, size_t len)
+{
+    char head[32];
+    int n = snprintf(head, sizeof(head), "%c %zu\n", tag, len);
+    return sendAll(fd, head, (size_t)n) && sendAll(fd, data, len);
+}
+// Helper: end a response with the status and the stage that set it
+void sendExit(int fd, int status, const char *stage)
+{
+    char line[64];
+    int n = snprintf(line, sizeof(line), "X %d %s\n", status, stage);
+    sendAll(fd, line, (size_t)n);
+}
+// Helper: receive exactly len bytes by deadline; returns 0 on EOF or error,
+// -1 once the deadline has passed
+int recvAll(int fd, char *buf, size_t len, double deadline)
+{
+    while (len > 0)
+    {
+        double left = deadline - now();
+        if (left <= 0)
+            return -1;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, left > 1 ? 1000 : (int)(left * 1000) + 1);
+        if (ready < 0 && errno != EINTR)
+            return 0;
+        if (ready <= 0)
+            continue;
+        ssize_t r = recv(fd, buf, len, 0);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return 0;
+        buf += r;
+        len -= (size_t)r;
+    }
+    return 1;
+}
+// Helper: write a whole buffer to a new scratch file
+int writeFile(const char *path, const char *data, size_t len)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        return 0;
+    while (len > 0)
+    {
+        ssize_t w = write(fd, data, len);
+        if (w <= 0)
+        {
+            close(fd);
+            return 0;
+        }
+        data += w;
+        len -= (size_t)w;
+    }
+    return close(fd) == 0;
+}
+/*
+Run one stage in a child forked from the worker. argv[0] names the stage.
+With client >= 0 the child's stdout and stderr stream to the client as O
+and E frames; otherwise both are collected in diag (up to MAX_DIAG bytes,
+*diagLen of them). Returns the exit status (128 + signal if it died), or
+-1 if it was still running KILL_GRACE seconds after deadline.
+*/
+int runStage(int (*stageMain)(int, char **), char **argv, int client, double deadline, char *diag, size_t *diagLen)
+{
+    int out[2], err[2];
+    if (pipe(out) != 0 || pipe(err) != 0)
+        return 1;
+    pid_t pid = fork();
+    if (pid < 0)
+        return 1;
+    if (pid == 0)
+    {
+        int devNull = open("/dev/null", O_RDONLY);
+        dup2(devNull, STDIN_FILENO);
+        dup2(out[1], STDOUT_FILENO);
+        dup2(err[1], STDERR_FILENO);
+        close(devNull), close(out[0]), close(out[1]), close(err[0]), close(err[1]);
+        close(listenFd);
+        if (client >= 0)
+            close(client);
+        signal(SIGPIPE, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        int argc = 0;
+        while (argv[argc])
+            argc++;
+        exit(stageMain(argc, argv));
+    }
+    close(out[1]);
+    close(err[1]);
+    struct pollfd fds[2] = {{out[0], POLLIN, 0}, {err[0], POLLIN, 0}};
+    int streams = 2, killed = 0;
+    char buf[1 << 16];
+    while (streams > 0)
+    {
+        double left = deadline + KILL_GRACE - now();
+        if (left <= 0 && !killed)
+        {
+            kill(pid, SIGKILL);
+            killed = 1;
+        }
+        if (poll(fds, 2, killed ? -1 : (int)(left * 1000) + 1) < 0)
+        {
+            if (errno != EINTR)
+                break;
+            continue;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            if (fds[i].fd < 0 || !fds[i].revents)
+                continue;
+            ssize_t r = read(fds[i].fd, buf, sizeof(buf));
+            if (r <= 0)
+            {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                streams--;
+            }
+            else if (client >= 0)
+                sendFrame(client, i == 0 ? 'O' : 'E', buf, (size_t)r);
+            else
+            {
+                size_t keep = (size_t)r < MAX_DIAG - *diagLen ? (size_t)r : MAX_DIAG - *diagLen;
+                memcpy(diag + *diagLen, buf, keep);
+                *diagLen += keep;
+            }
+        }
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        ;
+    if (killed)
+        return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+// Helper: report a stage that failed, with what it printed, and end the response
+void failStage(int client, int status, const char *stage, const char *diag, size_t diagLen)
+{
+    static const char limit[] = "Error: request time limit exceeded\n";
+    if (diagLen > 0)
+        sendFrame(client, 'E', diag, diagLen);
+    if (status < 0)
+        sendFrame(client, 'E', limit, sizeof(limit) - 1);
+    sendExit(client, status < 0 ? 4 : status, stage);
+}
+// Serve one request on an accepted connection
+void serveRequest(int client)
+{
+    static char diag[MAX_DIAG];
+    size_t diagLen = 0;
+    // The whole request, reading it included, runs against one deadline, so
+    // slow clients cannot hold a worker past the time cap
+    double start = now(), deadline = start + capSeconds;
+    // Header line
+    char head[MAX_HEADER + 1];
+    int len = 0, got = 1;
+    while (len < MAX_HEADER && (got = recvAll(client, head + len, 1, deadline)) > 0 && head[len] != '\n')
+        len++;
+    head[len] = '\0';
+    if (got < 0)
+    {
+        failStage(client, -1, "request", NULL, 0);
+        return;
+    }
+    char kind[16];
+    long long programLen, inputLen, steps = capSteps;
+    int used = 0, optimize = 0;
+    if (len == MAX_HEADER || sscanf(head, "PM0 %15s %lld %lld%n", kind, &programLen, &inputLen, &used) != 3 ||
+        (strcmp(kind, "source") != 0 && strcmp(kind, "object") != 0) ||
+        programLen < 0 || programLen > MAX_PROGRAM || inputLen < 0 || inputLen > MAX_INPUT)
+    {
+        static const char bad[] = "Error: bad request header\n";
+        sendFrame(client, 'E', bad, sizeof(bad) - 1);
+        sendExit(client, 2, "request");
+        return;
+    }
+    // Options: each one lowers a cap
+    for (char *opt = strtok(head + used, " "); opt; opt = strtok(NULL, " "))
+    {
+        long long n;
+        double s;
+        if (strcmp(opt, "O") == 0)
+            optimize = 1;
+        else if (sscanf(opt, "steps=%lld", &n) == 1 && n > 0 && (steps == 0 || n < steps))
+            steps = n;
+        else if (sscanf(opt, "time=%lf", &s) == 1 && s > 0 && s < capSeconds)
+            deadline = start + s;
+    }
+    // Payload: the program, then its input
+    char *payload = malloc((size_t)(programLen + inputLen) + 1);
+    got = payload ? recvAll(client, payload, (size_t)(programLen + inputLen), deadline) : 0;
+    if (got < 0)
+    {
+        failStage(client, -1, "request", NULL, 0);
+        free(payload);
+        return;
+    }
+    if (!got)
+    {
+        static const char bad[] = "Error: short request\n";
+        sendFrame(client, 'E', bad, sizeof(bad) - 1);
+        sendExit(client, 2, "request");
+        free(payload);
+        return;
+    }
+    // Scratch files of the previous request must not leak into this one
+    for (size_t i = 0; i < sizeof(scratchFiles) / sizeof(scratchFiles[0]); i++)
+        unlink(scratchFiles[i]);
+    const char *object = "elf.txt";
+    if (strcmp(kind, "object") == 0 && programLen >= 8 && memcmp(payload, "PM0PACK", 8) == 0)
+        object = "elf.bin";
+    int ok = writeFile(strcmp(kind, "source") == 0 ? "program.pl0" : object, payload, (size_t)programLen) &&
+             writeFile("input", payload + programLen, (size_t)inputLen);
+    free(payload);
+    if (!ok)
+    {
+        static const char bad[] = "Error: cannot write scratch files\n";
+        sendFrame(client, 'E', bad, sizeof(bad) - 1);
+        sendExit(client, 1, "request");
+        return;
+    }
+    // Compile: lex -b program.pl0, then parsercodegen -b [-O]
+    if (strcmp(kind, "source") == 0)
+    {
+        char *lexArgs[] = {"lex", "-b", "program.pl0", NULL};
+        int status = runStage(lex_main, lexArgs, -1, deadline, diag, &diagLen);
+        if (status != 0)
+        {
+            failStage(client, status, "lex", diag, diagLen);
+            return;
+        }
+        diagLen = 0;
+        char *compileArgs[] = {"parsercodegen", "-b", optimize ? "-O" : NULL, NULL};
+        status = runStage(parsercodegen_main, compileArgs, -1, deadline, diag, &diagLen);
+        if (status != 0)
+        {
+            failStage(client, status, "compile", diag, diagLen);
+            return;
+        }
+    }
+    // Run: the VM stops itself at the limits, with its usual summary
+    double left = deadline - now();
+    if (left <= 0)
+    {
+        failStage(client, -1, "compile", NULL, 0);
+        return;
+    }
+    char stepArg[32], timeArg[32];
+    snprintf(stepArg, sizeof(stepArg), "%lld", steps);
+    snprintf(timeArg, sizeof(timeArg), "%.3f", left < 0.001 ? 0.001 : left);
+    char *vmArgs[10] = {"vm", "--batch", "--input", "input", "--timeout", timeArg};
+    int n = 6;
+    if (steps > 0)
+        vmArgs[n++] = "--max-steps", vmArgs[n++] = stepArg;
+    vmArgs[n++] = (char *)object;
+    vmArgs[n] = NULL;
+    int status = runStage(vm_main, vmArgs, client, deadline, NULL, NULL);
+    failStage(client, status, "run", NULL, 0);
+}
+// Worker: accept and serve requests until the server stops
+void worker()
+{
+    signal(SIGINT, SIG_IGN);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    // Private scratch directory, kept for the worker's lifetime
+    const char *tmp = getenv("TMPDIR");
+    snprintf(workDir, sizeof(workDir), "%s/pm0d.XXXXXX", tmp && strlen(tmp) < 40 ? tmp : "/tmp");
+    if (!mkdtemp(workDir) || chdir(workDir) != 0)
+    {
+        perror("pm0d: scratch directory");
+        exit(1);
+    }
+    while (!stopping)
+    {
+        int client = accept(listenFd, NULL, NULL);
+        if (client < 0)
+            continue;
+        serveRequest(client);
+        close(client);
+    }
+    for (size_t i = 0; i < sizeof(scratchFiles) / sizeof(scratchFiles[0]); i++)
+        unlink(scratchFiles[i]);
+    if (chdir("/") == 0)
+        rmdir(workDir);
+    exit(0);
+}
+// Client (--run): send one request and relay the response
+int runClient(const char *socketPath, const char *kind, int optimize, long long steps, double seconds,
+              const char *programPath, const char *inputPath)
+{
+    char *data[2] = {NULL, NULL};
+    long sizes[2] = {0, 0};
+    const char *paths[2] = {programPath, inputPath};
+    for (int i = 0; i < 2; i++)
+    {
+        if (!paths[i])
+            continue;
+        FILE *f = fopen(paths[i], "rb");
+        if (!f || fseek(f, 0, SEEK_END) != 0 || (sizes[i] = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0 ||
+            !(data[i] = malloc((size_t)sizes[i] + 1)) || fread(data[i], 1, (size_t)sizes[i], f) != (size_t)sizes[i])
+        {
+            fprintf(stderr, "Error: cannot read %s\n", paths[i]);
+            return 1;
+        }
+        fclose(f);
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socketPath);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        perror("connect");
+        return 1;
+    }
+    char head[MAX_HEADER];
+    int n = snprintf(head, sizeof(head), "PM0 %s %ld %ld%s", kind, sizes[0], sizes[1], optimize ? " O" : "");
+    if (steps > 0)
+        n += snprintf(head + n, sizeof(head) - n, " steps=%lld", steps);
+    if (seconds > 0)
+        n += snprintf(head + n, sizeof(head) - n, " time=%g", seconds);
+    n += snprintf(head + n, sizeof(head) - n, "\n");
+    if (!sendAll(fd, head, (size_t)n) || !sendAll(fd, data[0], (size_t)sizes[0]) ||
+        (sizes[1] > 0 && !sendAll(fd, data[1], (size_t)sizes[1])))
+    {
+        fprintf(stderr, "Error: connection closed\n");
+        return 1;
+    }
+    shutdown(fd, SHUT_WR);
+    // Frames until the exit line
+    FILE *in = fdopen(fd, "r");
+    char line[MAX_HEADER], buf[1 << 16];
+    while (in && fgets(line, sizeof(line), in))
+    {
+        char tag;
+        long long len;
+        int status;
+        if (sscanf(line, "X %d", &status) == 1)
+            return status;
+        if (sscanf(line, "%c %lld", &tag, &len) != 2 || len < 0)
+            break;
+        FILE *to = (tag == 'O') ? stdout : stderr;
+        while (len > 0)
+        {
+            size_t got = fread(buf, 1, len < (long long)sizeof(buf) ? (size_t)len : sizeof(buf), in);
+            if (got == 0)
+                break;
+            fwrite(buf, 1, got, to);
+            len -= (long long)got;
+        }
+        fflush(to);
+    }
+    fprintf(stderr, "Error: incomplete response\n");
+    return 1;
+}
+int main(int argc, char *argv[])
+{
+    // Handle the Command Line
+    const char *socketPath = NULL, *programPath = NULL, *inputPath = NULL;
+    int workers = 4, client = 0, optimize = 0, object = 0, badArgs = 0;
+    long long steps = 0;
+    double seconds = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc)
+            steps = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+            if (!(seconds > 0))
+                badArgs = 1;
+        }
+        else if (strcmp(argv[i], "--run") == 0 && i + 1 < argc)
+            client = 1, socketPath = argv[++i];
+        else if (strcmp(argv[i], "-O") == 0)
+            optimize = 1;
+        else if (strcmp(argv[i], "--object") == 0)
+            object = 1;
+        else if (argv[i][0] == '-')
+            badArgs = 1;
+        else if (client && !programPath)
+            programPath = argv[i];
+        else if (client && !inputPath)
+            inputPath = argv[i];
+        else if (!client && !socketPath)
+            socketPath = argv[i];
+        else
+            badArgs = 1;
+    }
+    if (badArgs || !socketPath || (client && !programPath) || (!client && (optimize || object)) ||
+        workers < 1 || workers > MAX_WORKERS || steps < 0 || seconds < 0)
+    {
+        printf("Usage: ./pm0d [-c <workers>] [--max-steps <n>] [--timeout <seconds>] <socket>\n"
+               "       ./pm0d --run <socket> [-O] [--object] [--max-steps <n>] [--timeout <seconds>] <program> [<input>]\n");
+        return 1;
+    }
+    if (client)
+        return runClient(socketPath, object ? "object" : "source", optimize, steps, seconds, programPath, inputPath);
+    capSteps = steps;
+    if (seconds > 0)
+        capSeconds = seconds;
+    // Listening socket, replacing a stale one
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "Error: socket path too long\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath);
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listenFd, 128) != 0)
+    {
+        perror("pm0d");
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    // Worker pool: a worker that dies is replaced
+    pid_t pool[MAX_WORKERS];
+    for (int i = 0; i < workers; i++)
+        if ((pool[i] = fork()) == 0)
+            worker();
+    while (!stopping)
+    {
+        int status;
+        pid_t pid = wait(&status);
+        for (int i = 0; pid > 0 && !stopping && i < workers; i++)
+            if (pool[i] == pid && (pool[i] = fork()) == 0)
+                worker();
+    }
+    // Stop: workers finish their current request, then clean up
+    for (int i = 0; i < workers; i++)
+        if (pool[i] > 0)
+            kill(pool[i], SIGTERM);
+    while (wait(NULL) > 0 || errno == EINTR)
+        ;
+    unlink(socketPath);
+    return 0;
+}
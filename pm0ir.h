@@ -0,0 +1,908 @@
+// /*
+// pm0ir.h - Mid-level IR for PM/0 code (header only)
+// Used by parsercodegen.c (after code generation, under -O) and by the
+// standalone optimizer pm0opt.c, which reads existing object files.
+//
+// The code is split into basic blocks at jump and call targets and after
+// every JMP, JPC, TCL, RTN and halt. Each procedure (block 0 and every
+// CAL/TCL target) gets its own control-flow graph. Inside a procedure every
+// frame cell -- link cells, variables and the operand stack above them, all
+// addressed by their offset from BP -- carries SSA values: LOD 0 m reads the
+// cell's current value, STO 0 m gives it a new one, and blocks with several
+// predecessors start with phis (trivial ones are removed).
+//
+// While in IR form the M of JMP, JPC, CAL and TCL is a block number.
+// Passes edit the instruction lists of the blocks, call pm0ir_analyze()
+// again, and pm0ir_lower() lays the blocks out as PM/0 code once more.
+// */
+#ifndef PM0IR_H
+#define PM0IR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//PM/0 opcodes
+#define PM0_LIT 1
+#define PM0_OPR 2
+#define PM0_LOD 3
+#define PM0_STO 4
+#define PM0_CAL 5
+#define PM0_INC 6
+#define PM0_JMP 7
+#define PM0_JPC 8
+#define PM0_SYS 9
+#define PM0_TCL 10
+
+//SSA value kinds
+#define PM0V_CONST 1  // m = value
+#define PM0V_OPR   2  // m = OPR code, a and b = operands (b = -1 for EVEN)
+#define PM0V_LOAD  3  // LOD with L > 0 (l, m): a read of another frame
+#define PM0V_READ  4  // SYS 2
+#define PM0V_PHI   5  // m = cell; a = first argument in phiArgs, one per predecessor
+#define PM0V_LINK  6  // m = link cell (0..2) as set up by CAL
+#define PM0V_UNDEF 7  // cell allocated by INC and not stored yet
+#define PM0V_CALL  8  // variable cell after a CAL/TCL with L = 0 (the callee may store to it)
+
+typedef struct {
+  int kind, l, m;
+  int a, b;
+  int block;      // block that defines it
+} pm0ir_value;
+
+//One instruction with its SSA operands
+typedef struct {
+  int op, l, m;
+  int line;       // source line, 0 if unknown
+  int orig;       // index in the code the IR was built from, -1 if a pass inserted it
+  int in[2];      // values it pops (in[0] is the top for stores, JPC and SYS 1), -1 if none
+  int out;        // value it pushes, or the value a STO stores; -1 if none
+} pm0ir_ins;
+
+typedef struct {
+  pm0ir_ins *code;
+  int len, cap;
+  int succ[2], nsucc;
+  int *pred, npred;
+  int proc;       // owning procedure, -1 if no procedure reaches it
+  int depthIn;    // frame depth (cells from BP down) at entry, -1 if unknown
+  int depthOut;
+  int *in;        // value of each cell at entry (depthIn entries)
+  int *out;       // value of each cell at exit (depthOut entries)
+  int start;      // first instruction index after the last build or lowering
+} pm0ir_block;
+
+typedef struct {
+  int entry;      // entry block
+  int frame;      // size given by the INC at depth 0, -1 if none
+  int ok;         // 1 if depths are consistent and no block is shared, so SSA is valid
+} pm0ir_proc;
+
+typedef struct {
+  pm0ir_block *blocks;
+  int nblocks;
+  pm0ir_proc *procs;
+  int nprocs;
+  pm0ir_value *values;
+  int nvalues, capValues;
+  int *phiArgs;
+  int nphiArgs, capPhiArgs;
+  int *repl;      // replacement of each removed trivial phi, -1 if none
+  char error[96];
+} pm0ir;
+
+//Function to report whether an instruction's M is a code address
+static inline int pm0ir_is_branch(int op) {
+  return op == PM0_JMP || op == PM0_JPC || op == PM0_CAL || op == PM0_TCL;
+}
+
+//Function to report whether an instruction ends its block
+static inline int pm0ir_ends_block(const pm0ir_ins *in) {
+  return in->op == PM0_JMP || in->op == PM0_JPC || in->op == PM0_TCL ||
+         (in->op == PM0_OPR && in->m == 0) || (in->op == PM0_SYS && in->m == 3);
+}
+
+//Function to record an error; always returns 0
+static int pm0ir_fail(pm0ir *ir, const char *msg, int where) {
+  snprintf(ir->error, sizeof(ir->error), "%s (block %d)", msg, where);
+  return 0;
+}
+
+//Function to follow removed phis to the value that replaced them
+static inline int pm0ir_resolve(const pm0ir *ir, int v) {
+  while (v >= 0 && ir->repl[v] >= 0) v = ir->repl[v];
+  return v;
+}
+
+//Function to create an SSA value; returns its number or -1 when out of memory
+static int pm0ir_new_value(pm0ir *ir, int kind, int l, int m, int a, int b, int block) {
+  if (ir->nvalues == ir->capValues) {
+    int cap = ir->capValues ? 2 * ir->capValues : 256;
+    pm0ir_value *nv = realloc(ir->values, cap * sizeof(*nv));
+    int *nr = realloc(ir->repl, cap * sizeof(*nr));
+    if (nv) ir->values = nv;
+    if (nr) ir->repl = nr;
+    if (!nv || !nr) { pm0ir_fail(ir, "out of memory", block); return -1; }
+    ir->capValues = cap;
+  }
+  pm0ir_value *v = &ir->values[ir->nvalues];
+  v->kind = kind; v->l = l; v->m = m; v->a = a; v->b = b; v->block = block;
+  ir->repl[ir->nvalues] = -1;
+  return ir->nvalues++;
+}
+
+//Function to insert an instruction into a block before position pos
+static inline int pm0ir_insert(pm0ir *ir, int b, int pos, int op, int l, int m, int line) {
+  pm0ir_block *bl = &ir->blocks[b];
+  if (bl->len == bl->cap) {
+    int cap = bl->cap ? 2 * bl->cap : 8;
+    pm0ir_ins *nc = realloc(bl->code, cap * sizeof(*nc));
+    if (!nc) return pm0ir_fail(ir, "out of memory", b);
+    bl->code = nc;
+    bl->cap = cap;
+  }
+  memmove(&bl->code[pos + 1], &bl->code[pos], (bl->len - pos) * sizeof(pm0ir_ins));
+  pm0ir_ins *in = &bl->code[pos];
+  in->op = op; in->l = l; in->m = m; in->line = line;
+  in->orig = -1; in->in[0] = in->in[1] = -1; in->out = -1;
+  bl->len++;
+  return 1;
+}
+
+//Function to remove the instruction at position pos of a block
+static inline void pm0ir_remove(pm0ir *ir, int b, int pos) {
+  pm0ir_block *bl = &ir->blocks[b];
+  memmove(&bl->code[pos], &bl->code[pos + 1], (bl->len - pos - 1) * sizeof(pm0ir_ins));
+  bl->len--;
+}
+
+//Function to release the analysis results (CFG, procedures, SSA) but keep the code
+static void pm0ir_clear_analysis(pm0ir *ir) {
+  for (int b = 0; b < ir->nblocks; b++) {
+    free(ir->blocks[b].pred); free(ir->blocks[b].in); free(ir->blocks[b].out);
+    ir->blocks[b].pred = ir->blocks[b].in = ir->blocks[b].out = NULL;
+    ir->blocks[b].npred = ir->blocks[b].nsucc = 0;
+  }
+  free(ir->procs);
+  ir->procs = NULL; ir->nprocs = 0;
+  ir->nvalues = 0; ir->nphiArgs = 0;
+}
+
+//Function to release everything
+static void pm0ir_free(pm0ir *ir) {
+  pm0ir_clear_analysis(ir);
+  for (int b = 0; b < ir->nblocks; b++) free(ir->blocks[b].code);
+  free(ir->blocks); free(ir->values); free(ir->repl); free(ir->phiArgs);
+  memset(ir, 0, sizeof(*ir));
+}
+
+//Function to apply one instruction to the frame depth; returns -1 if it underflows
+static int pm0ir_step_depth(const pm0ir_ins *in, int d) {
+  int pops = 0, pushes = 0;
+  switch (in->op) {
+    case PM0_LIT: case PM0_LOD: pushes = 1; break;
+    case PM0_STO: case PM0_JPC: pops = 1; break;
+    case PM0_OPR:
+      if (in->m == 11) pops = pushes = 1;
+      else if (in->m != 0) { pops = 2; pushes = 1; }
+      break;
+    case PM0_INC: pushes = in->m; break;
+    case PM0_SYS: pops = (in->m == 1); pushes = (in->m == 2); break;
+  }
+  return (d < pops || pushes < 0) ? -1 : d - pops + pushes;
+}
+
+//Function to find the control-flow successors of every block and their predecessors
+static int pm0ir_link_blocks(pm0ir *ir) {
+  for (int b = 0; b < ir->nblocks; b++) {
+    pm0ir_block *bl = &ir->blocks[b];
+    pm0ir_ins *last = bl->len ? &bl->code[bl->len - 1] : NULL;
+    bl->nsucc = 0;
+    if (last && (last->op == PM0_JMP || last->op == PM0_JPC || last->op == PM0_TCL)) {
+      if (last->op == PM0_JPC && b + 1 < ir->nblocks) bl->succ[bl->nsucc++] = b + 1;
+      if (last->op != PM0_TCL) bl->succ[bl->nsucc++] = last->m;
+    } else if (!last || !pm0ir_ends_block(last)) {
+      if (b + 1 < ir->nblocks) bl->succ[bl->nsucc++] = b + 1;
+    }
+  }
+  for (int b = 0; b < ir->nblocks; b++) {
+    for (int k = 0; k < ir->blocks[b].nsucc; k++) ir->blocks[ir->blocks[b].succ[k]].npred++;
+  }
+  for (int b = 0; b < ir->nblocks; b++) {
+    ir->blocks[b].pred = malloc((ir->blocks[b].npred + 1) * sizeof(int));
+    if (!ir->blocks[b].pred) return pm0ir_fail(ir, "out of memory", b);
+    ir->blocks[b].npred = 0;
+  }
+  for (int b = 0; b < ir->nblocks; b++) {
+    for (int k = 0; k < ir->blocks[b].nsucc; k++) {
+      pm0ir_block *s = &ir->blocks[ir->blocks[b].succ[k]];
+      s->pred[s->npred++] = b;
+    }
+  }
+  return 1;
+}
+
+//Function to find the procedures, the blocks each one owns and the frame depth at every block
+static int pm0ir_find_procs(pm0ir *ir, int *work) {
+  if (ir->nblocks <= 0) return pm0ir_fail(ir, "empty program", 0);
+  char *isEntry = calloc(ir->nblocks, 1);
+  if (!isEntry) return pm0ir_fail(ir, "out of memory", 0);
+  isEntry[0] = 1;
+  for (int b = 0; b < ir->nblocks; b++) {
+    ir->blocks[b].proc = -1;
+    ir->blocks[b].depthIn = ir->blocks[b].depthOut = -1;
+    for (int i = 0; i < ir->blocks[b].len; i++) {
+      pm0ir_ins *in = &ir->blocks[b].code[i];
+      if (in->op == PM0_CAL || in->op == PM0_TCL) isEntry[in->m] = 1;
+    }
+  }
+  for (int b = 0; b < ir->nblocks; b++) ir->nprocs += isEntry[b];
+  ir->procs = malloc(ir->nprocs * sizeof(pm0ir_proc));
+  if (!ir->procs) { free(isEntry); return pm0ir_fail(ir, "out of memory", 0); }
+
+  int p = 0;
+  for (int e = 0; e < ir->nblocks; e++) {
+    if (!isEntry[e]) continue;
+    pm0ir_proc *proc = &ir->procs[p];
+    proc->entry = e; proc->frame = -1; proc->ok = 1;
+    int top = 0;
+    ir->blocks[e].depthIn = 0;
+    if (ir->blocks[e].proc >= 0) proc->ok = ir->procs[ir->blocks[e].proc].ok = 0;
+    ir->blocks[e].proc = p;
+    work[top++] = e;
+    while (top > 0) {
+      int b = work[--top];
+      pm0ir_block *bl = &ir->blocks[b];
+      int d = bl->depthIn;
+      for (int i = 0; i < bl->len && d >= 0; i++) {
+        if (bl->code[i].op == PM0_INC && d == 0 && proc->frame < 0) proc->frame = bl->code[i].m;
+        d = pm0ir_step_depth(&bl->code[i], d);
+      }
+      if (d < 0) { proc->ok = 0; continue; }
+      bl->depthOut = d;
+      for (int k = 0; k < bl->nsucc; k++) {
+        pm0ir_block *s = &ir->blocks[bl->succ[k]];
+        if (s->proc == p) {
+          if (s->depthIn != d) proc->ok = 0;
+          continue;
+        }
+        //A block reached from two procedures (or an entry reached by falling through) has no single frame
+        if (s->proc >= 0 || isEntry[bl->succ[k]]) {
+          proc->ok = 0;
+          if (s->proc >= 0) ir->procs[s->proc].ok = 0;
+          continue;
+        }
+        s->proc = p;
+        s->depthIn = d;
+        work[top++] = bl->succ[k];
+      }
+    }
+    p++;
+  }
+  free(isEntry);
+  return 1;
+}
+
+//Function to order a procedure's blocks so every block comes after its forward-edge predecessors
+static int pm0ir_reverse_postorder(const pm0ir *ir, int p, int *order, int *stack, char *seen) {
+  int n = 0, top = 0;
+  int entry = ir->procs[p].entry;
+  //stack holds (block, next successor) pairs for an iterative depth-first search
+  stack[top++] = entry; stack[top++] = 0;
+  seen[entry] = 1;
+  while (top > 0) {
+    int b = stack[top - 2], k = stack[top - 1];
+    const pm0ir_block *bl = &ir->blocks[b];
+    if (k < bl->nsucc) {
+      stack[top - 1]++;
+      int s = bl->succ[k];
+      if (!seen[s] && ir->blocks[s].proc == p) {
+        seen[s] = 1;
+        stack[top++] = s; stack[top++] = 0;
+      }
+    } else {
+      order[n++] = b;
+      top -= 2;
+    }
+  }
+  for (int i = 0; i < n / 2; i++) { int tmp = order[i]; order[i] = order[n - 1 - i]; order[n - 1 - i] = tmp; }
+  return n;
+}
+
+//Function to turn one block's instructions into SSA values, starting from the cells in cur
+static int pm0ir_number_block(pm0ir *ir, int b, int *cur) {
+  pm0ir_block *bl = &ir->blocks[b];
+  pm0ir_proc *proc = &ir->procs[bl->proc];
+  int d = bl->depthIn;
+  for (int i = 0; i < bl->len; i++) {
+    pm0ir_ins *in = &bl->code[i];
+    in->in[0] = in->in[1] = -1;
+    in->out = -1;
+    switch (in->op) {
+      case PM0_LIT:
+        in->out = cur[d++] = pm0ir_new_value(ir, PM0V_CONST, 0, in->m, -1, -1, b);
+        break;
+      case PM0_OPR:
+        if (in->m == 0) break;
+        if (in->m == 11) {
+          in->in[0] = cur[d - 1];
+          in->out = cur[d - 1] = pm0ir_new_value(ir, PM0V_OPR, 0, 11, in->in[0], -1, b);
+        } else {
+          in->in[0] = cur[d - 1]; in->in[1] = cur[d - 2];
+          in->out = cur[d - 2] = pm0ir_new_value(ir, PM0V_OPR, 0, in->m, in->in[1], in->in[0], b);
+          d--;
+        }
+        break;
+      case PM0_LOD:
+        if (in->l == 0) {
+          if (in->m < 0 || in->m >= d) return pm0ir_fail(ir, "LOD outside the frame", b);
+          in->out = cur[d++] = cur[in->m];
+        } else {
+          in->out = cur[d++] = pm0ir_new_value(ir, PM0V_LOAD, in->l, in->m, -1, -1, b);
+        }
+        break;
+      case PM0_STO:
+        in->in[0] = in->out = cur[--d];
+        if (in->l == 0) {
+          if (in->m < 0 || in->m >= d) return pm0ir_fail(ir, "STO outside the frame", b);
+          cur[in->m] = in->out;
+        }
+        break;
+      case PM0_CAL: case PM0_TCL:
+        //A callee whose static link is this frame can store into its variables
+        if (in->l == 0) {
+          int limit = (proc->frame < d) ? proc->frame : d;
+          for (int c = 3; c < limit; c++) cur[c] = pm0ir_new_value(ir, PM0V_CALL, 0, c, -1, -1, b);
+        }
+        break;
+      case PM0_INC:
+        for (int c = d; c < d + in->m; c++) {
+          cur[c] = pm0ir_new_value(ir, c < 3 ? PM0V_LINK : PM0V_UNDEF, 0, c, -1, -1, b);
+        }
+        d += in->m;
+        break;
+      case PM0_JPC:
+        in->in[0] = cur[--d];
+        break;
+      case PM0_SYS:
+        if (in->m == 1) in->in[0] = cur[--d];
+        else if (in->m == 2) in->out = cur[d++] = pm0ir_new_value(ir, PM0V_READ, 0, 0, -1, -1, b);
+        break;
+    }
+    if (ir->error[0]) return 0;
+  }
+  bl->out = malloc((d + 1) * sizeof(int));
+  if (!bl->out) return pm0ir_fail(ir, "out of memory", b);
+  memcpy(bl->out, cur, d * sizeof(int));
+  return 1;
+}
+
+//Function to replace phis whose arguments (other than the phi itself) are all one value
+static void pm0ir_remove_trivial_phis(pm0ir *ir) {
+  for (int changed = 1; changed; ) {
+    changed = 0;
+    for (int v = 0; v < ir->nvalues; v++) {
+      pm0ir_value *val = &ir->values[v];
+      if (val->kind != PM0V_PHI || val->a < 0 || ir->repl[v] >= 0) continue;
+      int same = -1, trivial = 1;
+      for (int k = 0; k < val->b; k++) {
+        int arg = pm0ir_resolve(ir, ir->phiArgs[val->a + k]);
+        if (arg < 0 || arg == v || arg == same) continue;
+        if (same >= 0) { trivial = 0; break; }
+        same = arg;
+      }
+      if (trivial && same >= 0) { ir->repl[v] = same; changed = 1; }
+    }
+  }
+}
+
+//Function to rewrite every reference to a removed phi with its replacement
+static void pm0ir_canonicalize(pm0ir *ir) {
+  for (int v = 0; v < ir->nvalues; v++) {
+    pm0ir_value *val = &ir->values[v];
+    if (val->kind == PM0V_OPR) {
+      val->a = pm0ir_resolve(ir, val->a);
+      val->b = pm0ir_resolve(ir, val->b);
+    }
+  }
+  for (int k = 0; k < ir->nphiArgs; k++) ir->phiArgs[k] = pm0ir_resolve(ir, ir->phiArgs[k]);
+  for (int b = 0; b < ir->nblocks; b++) {
+    pm0ir_block *bl = &ir->blocks[b];
+    if (bl->in) for (int c = 0; c < bl->depthIn; c++) bl->in[c] = pm0ir_resolve(ir, bl->in[c]);
+    if (bl->out) for (int c = 0; c < bl->depthOut; c++) bl->out[c] = pm0ir_resolve(ir, bl->out[c]);
+    for (int i = 0; i < bl->len; i++) {
+      pm0ir_ins *in = &bl->code[i];
+      in->in[0] = pm0ir_resolve(ir, in->in[0]);
+      in->in[1] = pm0ir_resolve(ir, in->in[1]);
+      in->out = pm0ir_resolve(ir, in->out);
+    }
+  }
+}
+
+//Function to build SSA values for one procedure whose depths are consistent
+static int pm0ir_build_ssa(pm0ir *ir, int p, int *order, int *stack, char *seen) {
+  int n = pm0ir_reverse_postorder(ir, p, order, stack, seen);
+  int maxDepth = 1;
+  for (int i = 0; i < n; i++) {
+    pm0ir_block *bl = &ir->blocks[order[i]];
+    int d = bl->depthIn;
+    for (int k = 0; k < bl->len; k++) {
+      d = pm0ir_step_depth(&bl->code[k], d);
+      if (d > maxDepth) maxDepth = d;
+    }
+    if (bl->depthIn > maxDepth) maxDepth = bl->depthIn;
+  }
+  int *cur = malloc((maxDepth + 1) * sizeof(int));
+  if (!cur) return pm0ir_fail(ir, "out of memory", ir->procs[p].entry);
+
+  for (int i = 0; i < n; i++) {
+    int b = order[i];
+    pm0ir_block *bl = &ir->blocks[b];
+    bl->in = malloc((bl->depthIn + 1) * sizeof(int));
+    if (!bl->in) { free(cur); return pm0ir_fail(ir, "out of memory", b); }
+    //One predecessor that is already numbered hands its cells over; otherwise each cell starts with a phi
+    if (b != ir->procs[p].entry && bl->npred == 1 && ir->blocks[bl->pred[0]].out) {
+      memcpy(bl->in, ir->blocks[bl->pred[0]].out, bl->depthIn * sizeof(int));
+    } else {
+      for (int c = 0; c < bl->depthIn; c++) {
+        bl->in[c] = pm0ir_new_value(ir, PM0V_PHI, 0, c, -1, bl->npred, b);
+        if (bl->in[c] < 0) { free(cur); return pm0ir_fail(ir, "out of memory", b); }
+      }
+    }
+    memcpy(cur, bl->in, bl->depthIn * sizeof(int));
+    if (!pm0ir_number_block(ir, b, cur)) { free(cur); return 0; }
+  }
+  free(cur);
+
+  //Phi arguments: the cell's value at the end of each predecessor (-1 if unreached)
+  for (int i = 0; i < n; i++) {
+    pm0ir_block *bl = &ir->blocks[order[i]];
+    for (int c = 0; c < bl->depthIn; c++) {
+      int v = bl->in[c];
+      if (ir->values[v].kind != PM0V_PHI || ir->values[v].block != order[i] || ir->values[v].a >= 0) continue;
+      if (ir->nphiArgs + bl->npred > ir->capPhiArgs) {
+        int cap = 2 * (ir->nphiArgs + bl->npred) + 64;
+        int *na = realloc(ir->phiArgs, cap * sizeof(int));
+        if (!na) return pm0ir_fail(ir, "out of memory", order[i]);
+        ir->phiArgs = na;
+        ir->capPhiArgs = cap;
+      }
+      ir->values[v].a = ir->nphiArgs;
+      for (int k = 0; k < bl->npred; k++) {
+        pm0ir_block *pb = &ir->blocks[bl->pred[k]];
+        ir->phiArgs[ir->nphiArgs++] = (pb->proc == p && pb->out && c < pb->depthOut) ? pb->out[c] : -1;
+      }
+    }
+  }
+  return 1;
+}
+
+//Function to (re)compute the CFG, procedures, frame depths and SSA values from the blocks' code
+static int pm0ir_analyze(pm0ir *ir) {
+  pm0ir_clear_analysis(ir);
+  ir->error[0] = '\0';
+  int *work = malloc((2 * ir->nblocks + 2) * sizeof(int));
+  int *order = malloc((ir->nblocks + 1) * sizeof(int));
+  char *seen = calloc(ir->nblocks + 1, 1);
+  int ok = work && order && seen && pm0ir_link_blocks(ir) && pm0ir_find_procs(ir, work);
+  for (int p = 0; ok && p < ir->nprocs; p++) {
+    if (!ir->procs[p].ok) continue;
+    memset(seen, 0, ir->nblocks + 1);
+    if (!pm0ir_build_ssa(ir, p, order, work, seen)) {
+      //Code the IR cannot model stays as it is; its procedure is left to the passes untouched
+      ir->procs[p].ok = 0;
+      ir->error[0] = '\0';
+    }
+  }
+  if (ok) {
+    pm0ir_remove_trivial_phis(ir);
+    pm0ir_canonicalize(ir);
+  } else if (!ir->error[0]) {
+    pm0ir_fail(ir, "out of memory", 0);
+  }
+  free(work); free(order); free(seen);
+  return ok;
+}
+
+//Function to split code into blocks and analyze it; returns 0 (with ir->error set) on failure
+static int pm0ir_build(pm0ir *ir, const pm0ir_ins *code, int n) {
+  memset(ir, 0, sizeof(*ir));
+  if (n <= 0) return pm0ir_fail(ir, "empty program", 0);
+  int *blockOf = calloc(n + 1, sizeof(int));
+  if (!blockOf) return pm0ir_fail(ir, "out of memory", 0);
+
+  //Leaders: the first instruction, every branch target and every instruction after a block end
+  blockOf[0] = 1;
+  for (int i = 0; i < n; i++) {
+    if (pm0ir_is_branch(code[i].op)) {
+      int target = code[i].m / 3;
+      if (code[i].m % 3 != 0 || target < 0 || target >= n) {
+        free(blockOf);
+        snprintf(ir->error, sizeof(ir->error), "jump or call target is not an instruction (instruction %d)", i);
+        return 0;
+      }
+      blockOf[target] = 1;
+    }
+    if (pm0ir_ends_block(&code[i])) blockOf[i + 1] = 1;
+  }
+  for (int i = 0; i < n; i++) ir->nblocks += blockOf[i];
+  for (int i = 0, b = -1; i < n; i++) {
+    if (blockOf[i]) b++;
+    blockOf[i] = b;
+  }
+
+  ir->blocks = calloc(ir->nblocks, sizeof(pm0ir_block));
+  if (!ir->blocks) { free(blockOf); return pm0ir_fail(ir, "out of memory", 0); }
+  for (int i = 0; i < n; i++) {
+    pm0ir_block *bl = &ir->blocks[blockOf[i]];
+    if (bl->len == 0) bl->start = i;
+    if (!pm0ir_insert(ir, blockOf[i], bl->len, code[i].op, code[i].l, code[i].m, code[i].line)) {
+      free(blockOf);
+      return 0;
+    }
+    pm0ir_ins *in = &bl->code[bl->len - 1];
+    in->orig = i;
+    if (pm0ir_is_branch(in->op)) in->m = blockOf[in->m / 3];
+  }
+  free(blockOf);
+  return pm0ir_analyze(ir);
+}
+
+//Function to lay the blocks out in order as PM/0 code; returns the length or -1 if it exceeds max
+static int pm0ir_lower(pm0ir *ir, pm0ir_ins *out, int max) {
+  int n = 0;
+  for (int b = 0; b < ir->nblocks; b++) {
+    ir->blocks[b].start = n;
+    n += ir->blocks[b].len;
+  }
+  if (n > max) return -1;
+  n = 0;
+  for (int b = 0; b < ir->nblocks; b++) {
+    for (int i = 0; i < ir->blocks[b].len; i++) {
+      out[n] = ir->blocks[b].code[i];
+      if (pm0ir_is_branch(out[n].op)) out[n].m = 3 * ir->blocks[out[n].m].start;
+      n++;
+    }
+  }
+  return n;
+}
+
+//Function to print one SSA value's definition
+static void pm0ir_dump_value(const pm0ir *ir, FILE *f, int v) {
+  static const char *oprName[] = {"RTN", "ADD", "SUB", "MUL", "DIV", "EQL", "NEQ", "LSS", "LEQ", "GTR", "GEQ", "EVEN"};
+  const pm0ir_value *val = &ir->values[v];
+  fprintf(f, "v%d = ", v);
+  switch (val->kind) {
+    case PM0V_CONST: fprintf(f, "%d", val->m); break;
+    case PM0V_OPR:
+      if (val->b < 0) fprintf(f, "%s v%d", oprName[val->m], val->a);
+      else fprintf(f, "%s v%d v%d", (val->m >= 0 && val->m <= 11) ? oprName[val->m] : "OPR", val->a, val->b);
+      break;
+    case PM0V_LOAD: fprintf(f, "load %d %d", val->l, val->m); break;
+    case PM0V_READ: fprintf(f, "read"); break;
+    case PM0V_PHI:
+      fprintf(f, "phi cell %d [", val->m);
+      for (int k = 0; k < val->b; k++) {
+        int arg = (val->a >= 0) ? ir->phiArgs[val->a + k] : -1;
+        fprintf(f, "%sB%d:", k ? ", " : "", ir->blocks[val->block].pred[k]);
+        if (arg >= 0) fprintf(f, "v%d", arg); else fprintf(f, "-");
+      }
+      fprintf(f, "]");
+      break;
+    case PM0V_LINK: fprintf(f, "link %d", val->m); break;
+    case PM0V_UNDEF: fprintf(f, "undef cell %d", val->m); break;
+    case PM0V_CALL: fprintf(f, "cell %d after call", val->m); break;
+  }
+}
+
+//Function to print the IR: procedures, blocks with their edges, phis and instructions with SSA values
+static void pm0ir_dump(const pm0ir *ir, FILE *f) {
+  static const char *opName[] = {"?", "LIT", "OPR", "LOD", "STO", "CAL", "INC", "JMP", "JPC", "SYS", "TCL"};
+  for (int p = 0; p < ir->nprocs; p++) {
+    fprintf(f, "proc %d: entry B%d, frame %d%s\n", p, ir->procs[p].entry, ir->procs[p].frame,
+            ir->procs[p].ok ? "" : " (no SSA)");
+  }
+  for (int b = 0; b < ir->nblocks; b++) {
+    const pm0ir_block *bl = &ir->blocks[b];
+    fprintf(f, "B%d: proc %d, depth %d -> %d, preds", b, bl->proc, bl->depthIn, bl->depthOut);
+    for (int k = 0; k < bl->npred; k++) fprintf(f, " B%d", bl->pred[k]);
+    fprintf(f, ", succs");
+    for (int k = 0; k < bl->nsucc; k++) fprintf(f, " B%d", bl->succ[k]);
+    fprintf(f, "\n");
+    for (int c = 0; bl->in && c < bl->depthIn; c++) {
+      int v = bl->in[c];
+      if (ir->values[v].kind == PM0V_PHI && ir->values[v].block == b && ir->repl[v] < 0) {
+        fprintf(f, "       ");
+        pm0ir_dump_value(ir, f, v);
+        fprintf(f, "\n");
+      }
+    }
+    for (int i = 0; i < bl->len; i++) {
+      const pm0ir_ins *in = &bl->code[i];
+      fprintf(f, "  %3s %3d %s%-5d", (in->op >= 1 && in->op <= 10) ? opName[in->op] : "?", in->l,
+              pm0ir_is_branch(in->op) ? "B" : "", in->m);
+      if (in->op == PM0_STO && in->out >= 0) fprintf(f, "  %s%d = v%d", in->l ? "store " : "cell ", in->m, in->out);
+      else if (in->op == PM0_LOD && in->l == 0 && in->out >= 0) fprintf(f, "  v%d (cell %d)", in->out, in->m);
+      else if (in->out >= 0 && ir->values[in->out].block == b && ir->values[in->out].kind != PM0V_PHI) {
+        fprintf(f, "  ");
+        pm0ir_dump_value(ir, f, in->out);
+      } else if (in->in[0] >= 0) fprintf(f, "  uses v%d", in->in[0]);
+      fprintf(f, "\n");
+    }
+  }
+}
+
+//Local value numbering (pm0ir_local_cse): one value number per distinct
+//computation in a block. Leaves are the block's entry values (SSA ids), so
+//cells that hold the same value on entry share a number.
+#define PM0VN_ENTRY 0   // x = SSA value of a cell at block entry
+#define PM0VN_CONST 1   // x = literal
+#define PM0VN_OPR   2   // x = OPR code, a and b = operand numbers (b = -1 for EVEN)
+#define PM0VN_FRESH 3   // x = counter: a read, a load, a cell after a call
+
+typedef struct { int kind, x, a, b; } pm0ir_vn;
+
+typedef struct {
+  pm0ir_vn *vn;
+  int nvn, cap, fresh;
+  int failed;     // out of memory
+} pm0ir_vntab;
+
+//Function to find or add a value number
+static int pm0ir_vn_get(pm0ir_vntab *t, int kind, int x, int a, int b) {
+  if (kind != PM0VN_FRESH) {
+    for (int i = 0; i < t->nvn; i++) {
+      pm0ir_vn *e = &t->vn[i];
+      if (e->kind == kind && e->x == x && e->a == a && e->b == b) return i;
+    }
+  } else {
+    x = t->fresh++;
+  }
+  if (t->nvn == t->cap) {
+    int cap = t->cap ? 2 * t->cap : 64;
+    pm0ir_vn *nv = realloc(t->vn, cap * sizeof(*nv));
+    if (!nv) { t->failed = 1; return -1; }
+    t->vn = nv;
+    t->cap = cap;
+  }
+  t->vn[t->nvn].kind = kind; t->vn[t->nvn].x = x; t->vn[t->nvn].a = a; t->vn[t->nvn].b = b;
+  return t->nvn++;
+}
+
+//Function to find the INC that allocates procedure p's frame (the one executed at depth 0)
+static pm0ir_ins *pm0ir_frame_inc(pm0ir *ir, int p) {
+  for (int b = 0; b < ir->nblocks; b++) {
+    pm0ir_block *bl = &ir->blocks[b];
+    if (bl->proc != p || bl->depthIn != 0) continue;
+    int d = 0;
+    for (int i = 0; i < bl->len && d >= 0; i++) {
+      if (bl->code[i].op == PM0_INC && d == 0) return &bl->code[i];
+      d = pm0ir_step_depth(&bl->code[i], d);
+    }
+  }
+  return NULL;
+}
+
+//Function to replace code[s..e] of block b with one instruction
+static int pm0ir_replace_range(pm0ir *ir, int b, int s, int e, int op, int l, int m) {
+  int line = ir->blocks[b].code[e].line;
+  for (int k = e; k >= s; k--) pm0ir_remove(ir, b, k);
+  return pm0ir_insert(ir, b, s, op, l, m, line);
+}
+
+//Per-instruction results of simulating a block for CSE
+typedef struct {
+  int val;      // value number pushed, -1 if none
+  int start;    // first instruction of the side-effect-free range computing it, -1 if impure
+  int cost;     // cost of that range (a LOD with L > 0 also walks L static links)
+  int oprs;     // OPRs in the range
+  int holder;   // variable or temp cell holding the same value at this point, -1 if none
+  int calls;    // CAL/TCL with L = 0 executed so far in the block
+} pm0ir_cse_info;
+
+//Function to simulate one block and apply the first rewrite that pays off.
+//Returns 0 if nothing changed, 1 after a rewrite, 2 if the frame grew
+//(the caller must run pm0ir_analyze again) and -1 when out of memory.
+static int pm0ir_cse_step(pm0ir *ir, int b, int origFrame, int *temps) {
+  pm0ir_block *bl = &ir->blocks[b];
+  int frame = ir->procs[bl->proc].frame;
+  int n = bl->len, result = 0;
+  int maxDepth = bl->depthIn + 1, d = bl->depthIn;
+  for (int i = 0; i < n; i++) {
+    d = pm0ir_step_depth(&bl->code[i], d);
+    if (d + 1 > maxDepth) maxDepth = d + 1;
+  }
+  pm0ir_vntab t = {NULL, 0, 0, 0, 0};
+  pm0ir_cse_info *info = malloc((n + 1) * sizeof(*info));
+  int *cur = malloc(maxDepth * sizeof(int)), *since = malloc(maxDepth * sizeof(int));
+  int *rs = malloc(maxDepth * sizeof(int)), *rc = malloc(maxDepth * sizeof(int)), *ro = malloc(maxDepth * sizeof(int));
+  int *lastStore = malloc(maxDepth * sizeof(int)), *storeStart = malloc(maxDepth * sizeof(int));
+  int *memo = malloc((3 * n + 3) * sizeof(int)), nmemo = 0;   // (l, m, value) of known non-local cells
+  if (!info || !cur || !since || !rs || !rc || !ro || !lastStore || !storeStart || !memo) { result = -1; goto done; }
+
+  for (int c = 0; c < bl->depthIn; c++) {
+    cur[c] = pm0ir_vn_get(&t, PM0VN_ENTRY, bl->in[c], -1, -1);
+    since[c] = -1; lastStore[c] = -1; rs[c] = -1;
+  }
+  d = bl->depthIn;
+  int calls = 0;
+  for (int i = 0; i < n; i++) {
+    pm0ir_ins *in = &bl->code[i];
+    pm0ir_cse_info *f = &info[i];
+    f->val = -1; f->start = -1; f->cost = 0; f->oprs = 0; f->holder = -1; f->calls = calls;
+    int v = -1, s = i, cost = 1, oprs = 0;
+    switch (in->op) {
+      case PM0_LIT: v = pm0ir_vn_get(&t, PM0VN_CONST, in->m, -1, -1); break;
+      case PM0_LOD:
+        if (in->l == 0) {
+          v = cur[in->m];
+          lastStore[in->m] = -1;   // the cell is read, so its last store is live
+        } else {
+          for (int k = 0; k < nmemo; k++) if (memo[3 * k] == in->l && memo[3 * k + 1] == in->m) v = memo[3 * k + 2];
+          if (v < 0) {
+            v = pm0ir_vn_get(&t, PM0VN_FRESH, 0, -1, -1);
+            memo[3 * nmemo] = in->l; memo[3 * nmemo + 1] = in->m; memo[3 * nmemo + 2] = v; nmemo++;
+          }
+          cost = 1 + in->l;
+        }
+        break;
+      case PM0_OPR:
+        if (in->m == 0) break;
+        if (in->m == 11) {
+          v = pm0ir_vn_get(&t, PM0VN_OPR, 11, cur[d - 1], -1);
+          s = rs[d - 1]; cost = rc[d - 1] + 1; oprs = ro[d - 1] + 1;
+          d--;
+        } else {
+          int a = cur[d - 2], c2 = cur[d - 1];
+          //ADD, MUL, EQL and NEQ are commutative
+          if ((in->m == 1 || in->m == 3 || in->m == 5 || in->m == 6) && a > c2) { int tmp = a; a = c2; c2 = tmp; }
+          v = pm0ir_vn_get(&t, PM0VN_OPR, in->m, a, c2);
+          s = (rs[d - 2] >= 0 && rs[d - 1] >= 0) ? rs[d - 2] : -1;
+          cost = rc[d - 2] + rc[d - 1] + 1; oprs = ro[d - 2] + ro[d - 1] + 1;
+          d -= 2;
+        }
+        break;
+      case PM0_STO: {
+        int val = cur[d - 1], vs = rs[d - 1];
+        d--;
+        if (in->l == 0) {
+          int c = in->m;
+          //Storing the value the cell already holds
+          if (cur[c] == val && vs >= 0 && c >= 3) {
+            for (int k = i; k >= vs; k--) pm0ir_remove(ir, b, k);
+            result = 1; goto done;
+          }
+          //The previous store to this cell in the block was never read
+          if (c >= 3 && c < frame && lastStore[c] >= 0 && storeStart[c] >= 0) {
+            int ps = storeStart[c], pe = lastStore[c];
+            for (int k = pe; k >= ps; k--) pm0ir_remove(ir, b, k);
+            result = 1; goto done;
+          }
+          cur[c] = val; since[c] = i;
+          lastStore[c] = i; storeStart[c] = vs;
+        } else {
+          int k = 0;
+          while (k < nmemo && !(memo[3 * k] == in->l && memo[3 * k + 1] == in->m)) k++;
+          if (k < nmemo && memo[3 * k + 2] == val && vs >= 0) {
+            for (int k = i; k >= vs; k--) pm0ir_remove(ir, b, k);
+            result = 1; goto done;
+          }
+          if (k == nmemo) nmemo++;
+          memo[3 * k] = in->l; memo[3 * k + 1] = in->m; memo[3 * k + 2] = val;
+        }
+        break;
+      }
+      case PM0_CAL: case PM0_TCL:
+        //The callee may store to any non-local cell, and with L = 0 to this frame too
+        nmemo = 0;
+        if (in->l == 0) {
+          for (int c = 3; c < frame && c < d; c++) {
+            cur[c] = pm0ir_vn_get(&t, PM0VN_FRESH, 0, -1, -1);
+            since[c] = i; lastStore[c] = -1;
+          }
+          calls++;
+        }
+        break;
+      case PM0_INC:
+        for (int c = d; c < d + in->m; c++) {
+          cur[c] = pm0ir_vn_get(&t, PM0VN_FRESH, 0, -1, -1);
+          since[c] = -1; lastStore[c] = -1; rs[c] = -1;
+        }
+        d += in->m;
+        break;
+      case PM0_JPC: d--; break;
+      case PM0_SYS:
+        if (in->m == 1) d--;
+        else if (in->m == 2) { v = pm0ir_vn_get(&t, PM0VN_FRESH, 0, -1, -1); s = -1; }
+        break;
+    }
+    if (t.failed) { result = -1; goto done; }
+    if (v < 0) continue;
+    cur[d] = v; rs[d] = s; rc[d] = cost; ro[d] = oprs;
+    d++;
+    f->val = v; f->start = s; f->cost = cost; f->oprs = oprs;
+
+    //Best holder: a variable (or a temp stored in this block) with this value, stored earliest
+    for (int c = 3; c < frame && c < d - 1; c++) {
+      if (cur[c] != v || (c >= origFrame && since[c] < 0)) continue;
+      if (f->holder < 0 || since[c] < since[f->holder]) f->holder = c;
+    }
+    if (s < 0 || f->holder < 0) continue;
+    //Reload the holder instead of recomputing; a plain copy moves to the earliest holder
+    int h = f->holder;
+    int copyOf = (s == i && in->op == PM0_LOD && in->l == 0) ? in->m : -1;
+    if (cost > 1 || (copyOf >= 0 && copyOf != h && since[h] < since[copyOf])) {
+      pm0ir_replace_range(ir, b, s, i, PM0_LOD, 0, h);
+      result = 1; goto done;
+    }
+  }
+
+  //No holder anywhere: keep the most profitable repeated value in a temp cell
+  int best = -1, bestSave = -1;
+  for (int i = 0; i < n; i++) {
+    if (info[i].val < 0 || info[i].start < 0 || info[i].holder >= 0) continue;
+    int first = -1, save = -2, oprs = 0, repeats = 0;
+    for (int j = 0; j < i; j++) {
+      if (info[j].val == info[i].val && info[j].start >= 0) { first = j; break; }
+    }
+    if (first >= 0) continue;   // counted with its first occurrence
+    for (int j = i + 1; j < n; j++) {
+      if (info[j].val != info[i].val || info[j].start < 0 || info[j].calls != info[i].calls) continue;
+      save += info[j].cost - 1; oprs += info[j].oprs; repeats++;
+    }
+    if (repeats == 0 || save < 0 || (save == 0 && oprs == 0)) continue;
+    if (save > bestSave) { best = i; bestSave = save; }
+  }
+  if (best >= 0) {
+    int temp = origFrame + (*temps)++;
+    int grew = 0;
+    if (temp >= frame) {
+      pm0ir_ins *inc = pm0ir_frame_inc(ir, bl->proc);
+      if (!inc) goto done;
+      inc->m = temp + 1;
+      grew = 1;
+    }
+    for (int j = n - 1; j > best; j--) {
+      if (info[j].val != info[best].val || info[j].start < 0 || info[j].calls != info[best].calls) continue;
+      if (!pm0ir_replace_range(ir, b, info[j].start, j, PM0_LOD, 0, temp)) { result = -1; goto done; }
+    }
+    int line = bl->code[best].line;
+    if (!pm0ir_insert(ir, b, best + 1, PM0_STO, 0, temp, line) ||
+        !pm0ir_insert(ir, b, best + 2, PM0_LOD, 0, temp, line)) { result = -1; goto done; }
+    result = grew ? 2 : 1;
+  }
+
+done:
+  free(t.vn); free(info); free(cur); free(since); free(rs); free(rc); free(ro);
+  free(lastStore); free(storeStart); free(memo);
+  return result;
+}
+
+//CSE and copy propagation within basic blocks. Repeated side-effect-free
+//computations are reloaded from a cell that already holds the value, or
+//from a temp cell added to the frame (temps live within one block, so blocks
+//share them). Loads of other frames are forwarded from earlier loads and
+//stores until a call, and stores of a value the cell already holds or that
+//are overwritten before any read are dropped. Returns 1 if the code changed.
+static int pm0ir_local_cse(pm0ir *ir) {
+  int changed = 0;
+  int *origFrame = malloc((ir->nprocs + 1) * sizeof(int));
+  if (!origFrame) return 0;
+  for (int p = 0; p < ir->nprocs; p++) origFrame[p] = ir->procs[p].frame;
+  for (int b = 0; b < ir->nblocks; b++) {
+    int temps = 0;
+    for (;;) {
+      pm0ir_block *bl = &ir->blocks[b];
+      if (bl->proc < 0 || !ir->procs[bl->proc].ok || !bl->in || ir->procs[bl->proc].frame < 3) break;
+      int r = pm0ir_cse_step(ir, b, origFrame[bl->proc], &temps);
+      if (r <= 0) break;
+      changed = 1;
+      if (r == 2 && !pm0ir_analyze(ir)) break;
+    }
+  }
+  free(origFrame);
+  if (changed) pm0ir_analyze(ir);
+  return changed;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+Standalone PM/0 optimizer
+Reads an object file (elf.txt from parsercodegen or any other compiler),
+builds the mid-level IR from pm0ir.h, runs the IR passes on it and writes
+the code back out.
+Language: C (only)
+To Compile:
+gcc -O2 -std=c11 -o pm0opt pm0opt.c
+To Execute:
+./pm0opt [--dump] [--no-cse] [-o <out.txt>] elf.txt
+where:
+--dump    print the IR (blocks, CFG and SSA values) to stderr after the passes
+--no-cse  skip common-subexpression elimination within basic blocks
+-o        write the optimized code to <out.txt> instead of stdout
+Notes:
+- '#' header lines are dropped: frame sizes and stack needs may no longer
+  hold after optimization, and the VM runs headerless programs as before
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm0ir.h"
+// Largest program accepted
+#define MAX_CODE 100000
+pm0ir_ins code[MAX_CODE];
+int codeLen = 0;
+// Read the op L M triples of an object file, skipping '#' header lines
+int readObject(FILE *in)
+{
+    char line[128];
+    while (fgets(line, sizeof(line), in))
+    {
+        if (line[0] == '#')
+            continue;
+        int op, l, m;
+        if (sscanf(line, "%d %d %d", &op, &l, &m) != 3)
+            continue;
+        if (codeLen >= MAX_CODE)
+        {
+            fprintf(stderr, "Error: program has more than %d instructions\n", MAX_CODE);
+            return 0;
+        }
+        memset(&code[codeLen], 0, sizeof(code[codeLen]));
+        code[codeLen].op = op;
+        code[codeLen].l = l;
+        code[codeLen].m = m;
+        codeLen++;
+    }
+    return 1;
+}
+int main(int argc, char *argv[])
+{
+    // Handle the Command Line
+    const char *inPath = NULL;
+    const char *outPath = NULL;
+    int dump = 0, cse = 1;
+    int badArgs = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--dump") == 0)
+            dump = 1;
+        else if (strcmp(argv[i], "--no-cse") == 0)
+            cse = 0;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else if (!inPath && argv[i][0] != '-')
+            inPath = argv[i];
+        else
+            badArgs = 1;
+    }
+    if (badArgs || !inPath)
+    {
+        printf("Usage: ./pm0opt [--dump] [--no-cse] [-o <out.txt>] elf.txt\n");
+        return 1;
+    }
+    FILE *in = fopen(inPath, "r");
+    if (!in)
+    {
+        printf("Error: cannot open input file\n");
+        return 1;
+    }
+    int loaded = readObject(in);
+    fclose(in);
+    if (!loaded)
+        return 1;
+    // Build the IR
+    pm0ir ir;
+    if (!pm0ir_build(&ir, code, codeLen))
+    {
+        fprintf(stderr, "Error: %s\n", ir.error);
+        pm0ir_free(&ir);
+        return 1;
+    }
+    // Run the IR passes
+    if (cse)
+        pm0ir_local_cse(&ir);
+    if (dump)
+        pm0ir_dump(&ir, stderr);
+    // Lower it back to PM/0 and write it out
+    int n = pm0ir_lower(&ir, code, MAX_CODE);
+    pm0ir_free(&ir);
+    if (n < 0)
+    {
+        fprintf(stderr, "Error: optimized program has more than %d instructions\n", MAX_CODE);
+        return 1;
+    }
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out)
+    {
+        printf("Error: cannot open output file\n");
+        return 1;
+    }
+    for (int i = 0; i < n; i++)
+        fprintf(out, "%d %d %d\n", code[i].op, code[i].l, code[i].m);
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
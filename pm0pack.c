@@ -0,0 +1,127 @@
+/*
+PM/0 packed object converter
+Converts an object file of op L M triples (elf.txt) into the packed
+one-word-per-instruction format of pm0pack.h, or back with -d.
+Language: C (only)
+To Compile:
+gcc -O2 -std=c11 -o pm0pack pm0pack.c
+To Execute:
+./pm0pack [-d] <in> <out>
+where:
+-d  unpack: read a packed program and write triples (with its "# stack"
+    header line when the packed program records one)
+Notes:
+- Packing keeps the "# stack" header line; other '#' lines are dropped
+- Jump and call targets must be instruction addresses (multiples of 3)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm0pack.h"
+// Pack the triples in <in> into <out>
+int pack(FILE *in, FILE *out)
+{
+    char line[128];
+    int cap = 256, n = 0, stack = -1;
+    int *code = malloc(cap * sizeof(int));
+    while (code && fgets(line, sizeof(line), in))
+    {
+        int op, l, m;
+        if (line[0] == '#')
+        {
+            sscanf(line, "# stack %d", &stack);
+            continue;
+        }
+        if (sscanf(line, "%d %d %d", &op, &l, &m) != 3)
+            continue;
+        if (3 * n + 3 > cap)
+        {
+            cap *= 2;
+            code = realloc(code, cap * sizeof(int));
+            if (!code)
+                break;
+        }
+        code[3 * n] = op;
+        code[3 * n + 1] = l;
+        code[3 * n + 2] = m;
+        n++;
+    }
+    int32_t *words = malloc((n + 1) * sizeof(int32_t)), *wide = malloc((2 * n + 1) * sizeof(int32_t));
+    if (!code || !words || !wide)
+    {
+        fprintf(stderr, "Error: out of memory\n");
+        return 0;
+    }
+    int bad = 0;
+    int nwide = pm0pack_encode(code, n, words, wide, &bad);
+    if (nwide < 0)
+    {
+        fprintf(stderr, "Error: instruction %d cannot be packed (opcode above 15 or target not an instruction)\n", bad);
+        return 0;
+    }
+    if (!pm0pack_write(out, words, n, wide, nwide, stack))
+    {
+        fprintf(stderr, "Error: cannot write output file\n");
+        return 0;
+    }
+    free(code);
+    free(words);
+    free(wide);
+    return 1;
+}
+// Unpack the packed program in <in> into triples in <out>
+int unpack(FILE *in, FILE *out)
+{
+    pm0pack_header h;
+    int32_t *words, *wide;
+    if (fread(&h, sizeof(h), 1, in) != 1 || !pm0pack_read(in, &h, &words, &wide))
+    {
+        fprintf(stderr, "Error: not a packed PM/0 program\n");
+        return 0;
+    }
+    if (h.stack >= 0)
+        fprintf(out, "# stack %d\n", h.stack);
+    for (int i = 0; i < h.codeLen; i++)
+    {
+        int op = pm0pack_op(words[i]), l = pm0pack_l(words[i]), m = pm0pack_m(words[i]);
+        if (op == PM0PACK_ESCAPE)
+        {
+            op = l;
+            l = wide[2 * m];
+            m = wide[2 * m + 1];
+        }
+        if (pm0pack_is_target(op))
+            m *= 3;
+        fprintf(out, "%d %d %d\n", op, l, m);
+    }
+    free(words);
+    free(wide);
+    return 1;
+}
+int main(int argc, char *argv[])
+{
+    // Handle the Command Line
+    int decode = (argc == 4 && strcmp(argv[1], "-d") == 0);
+    if (argc != 3 + decode)
+    {
+        printf("Usage: ./pm0pack [-d] <in> <out>\n");
+        return 1;
+    }
+    FILE *in = fopen(argv[1 + decode], decode ? "rb" : "r");
+    if (!in)
+    {
+        printf("Error: cannot open input file\n");
+        return 1;
+    }
+    FILE *out = fopen(argv[2 + decode], decode ? "w" : "wb");
+    if (!out)
+    {
+        printf("Error: cannot open output file\n");
+        return 1;
+    }
+    int ok = decode ? unpack(in, out) : pack(in, out);
+    fclose(in);
+    if (fclose(out) != 0)
+        ok = 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*
+Packed PM/0 object format, shared by parsercodegen.c (writer), vm.c
+(loader) and pm0pack.c (converter). Header-only.
+
+Each instruction is one 32-bit word:
+  bits 0-3 op, bits 4-7 L, bits 8-31 M (signed)
+CAL/JMP/JPC/TCL targets are instruction indices (one word per instruction)
+rather than the triples' word addresses (3 per instruction). An instruction
+whose L or M does not fit is escaped: its op field is PM0PACK_ESCAPE (no
+PM/0 operation is 0), its L field holds the real op and its M field indexes
+the wide table, which holds the real L and M.
+
+File: a pm0pack_header, codeLen words, then wideCount (L, M) pairs, all
+int32 in host byte order.
+*/
+#ifndef PM0PACK_H
+#define PM0PACK_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#define PM0PACK_MAGIC "PM0PACK"
+#define PM0PACK_VERSION 1
+#define PM0PACK_ESCAPE 0 // op field of an escaped instruction
+#define PM0PACK_M_MIN (-(1 << 23))
+#define PM0PACK_M_MAX ((1 << 23) - 1)
+typedef struct
+{
+    char magic[8]; // PM0PACK_MAGIC
+    int32_t version;
+    int32_t codeLen, wideCount;
+    int32_t stack; // worst-case stack cells (the triples' "# stack" line), -1 if unknown
+} pm0pack_header;
+// Operations whose M is a code address
+static inline int pm0pack_is_target(int op)
+{
+    return op == 5 || op == 7 || op == 8 || op == 10;
+}
+// Fields of a packed word (M is sign-extended from 24 bits)
+static inline int pm0pack_op(int32_t w) { return w & 15; }
+static inline int pm0pack_l(int32_t w) { return (w >> 4) & 15; }
+static inline int pm0pack_m(int32_t w) { return w >> 8; } // arithmetic shift, as gcc and clang do
+static inline int32_t pm0pack_word(int op, int l, int m)
+{
+    return (int32_t)((uint32_t)op | (uint32_t)l << 4 | (uint32_t)m << 8);
+}
+/*
+Encode n op L M triples (code[3i], code[3i+1], code[3i+2], targets as word
+addresses). words gets n entries and wide up to 2n. Returns the number of
+wide entries, or -1 with the failing instruction in *bad if an op does not
+fit in 4 bits or a target is not an instruction.
+*/
+static inline int pm0pack_encode(const int *code, int n, int32_t *words, int32_t *wide, int *bad)
+{
+    int nwide = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int op = code[3 * i], l = code[3 * i + 1], m = code[3 * i + 2];
+        if (op < 0 || op > 15 || (pm0pack_is_target(op) && m % 3 != 0))
+        {
+            *bad = i;
+            return -1;
+        }
+        if (pm0pack_is_target(op))
+            m /= 3;
+        if (op != PM0PACK_ESCAPE && l >= 0 && l <= 15 && m >= PM0PACK_M_MIN && m <= PM0PACK_M_MAX)
+            words[i] = pm0pack_word(op, l, m);
+        else
+        {
+            wide[2 * nwide] = l;
+            wide[2 * nwide + 1] = m;
+            words[i] = pm0pack_word(PM0PACK_ESCAPE, op, nwide++);
+        }
+    }
+    return nwide;
+}
+// Write an encoded program; returns 1 on success
+static inline int pm0pack_write(FILE *f, const int32_t *words, int n, const int32_t *wide, int nwide, int stack)
+{
+    pm0pack_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, PM0PACK_MAGIC, sizeof(h.magic));
+    h.version = PM0PACK_VERSION;
+    h.codeLen = n;
+    h.wideCount = nwide;
+    h.stack = stack;
+    return fwrite(&h, sizeof(h), 1, f) == 1 &&
+           fwrite(words, sizeof(int32_t), (size_t)n, f) == (size_t)n &&
+           fwrite(wide, sizeof(int32_t), 2 * (size_t)nwide, f) == 2 * (size_t)nwide;
+}
+/*
+Read the rest of a packed program whose header is already in *h. *words
+and *wide are malloc'ed. Returns 0 on a short file or an escape that
+indexes past the wide table.
+*/
+static inline int pm0pack_read(FILE *f, const pm0pack_header *h, int32_t **words, int32_t **wide)
+{
+    *words = NULL;
+    *wide = NULL;
+    if (memcmp(h->magic, PM0PACK_MAGIC, sizeof(h->magic)) != 0 || h->version != PM0PACK_VERSION ||
+        h->codeLen < 0 || h->wideCount < 0 || h->wideCount > h->codeLen)
+        return 0;
+    *words = malloc((h->codeLen > 0 ? (size_t)h->codeLen : 1) * sizeof(int32_t));
+    *wide = malloc((h->wideCount > 0 ? 2 * (size_t)h->wideCount : 1) * sizeof(int32_t));
+    if (!*words || !*wide ||
+        fread(*words, sizeof(int32_t), (size_t)h->codeLen, f) != (size_t)h->codeLen ||
+        fread(*wide, sizeof(int32_t), 2 * (size_t)h->wideCount, f) != 2 * (size_t)h->wideCount)
+        return 0;
+    for (int i = 0; i < h->codeLen; i++)
+    {
+        int m = pm0pack_m((*words)[i]);
+        if (pm0pack_op((*words)[i]) == PM0PACK_ESCAPE && (m < 0 || m >= h->wideCount))
+            return 0;
+    }
+    return 1;
+}
+#endif
@@ -0,0 +1,21 @@
+/*
+Binary token stream (tokens.bin) written by ./lex -b and mapped by
+./parsercodegen -b. Layout, all int32 in host byte order:
+  pm0tokens_header
+  type[count]       token type numbers, as in the text token list
+  value[count]      numbersym: the decoded value; identsym: offset of the
+                    name in the string table; other tokens: 0
+  strings[strBytes] identifier names, each NUL-terminated
+*/
+#ifndef PM0TOKENS_H
+#define PM0TOKENS_H
+#include <stdint.h>
+#define PM0TOKENS_MAGIC "PM0TOKS"
+#define PM0TOKENS_VERSION 1
+typedef struct {
+  char magic[8];      // PM0TOKENS_MAGIC
+  int32_t version;
+  int32_t count;      // tokens
+  int32_t strBytes;   // size of the string table
+} pm0tokens_header;
+#endif
@@ -0,0 +1,148 @@
+/*
+PM/0 trace printer
+Turns a binary trace from ./vm --trace-bin back into the text trace the VM
+prints, byte for byte, optionally keeping only some instructions.
+Language: C (only)
+To Compile:
+gcc -O2 -std=c11 -o pm0trace pm0trace.c
+To Execute:
+./pm0trace [--pc <lo>:<hi>] [--proc <entry>] trace.bin
+where:
+--pc    keep instructions whose code address is between <lo> and <hi>
+        (inclusive, the addresses the PC column shows)
+--proc  keep instructions of the procedure whose first instruction is
+        <entry> (an instruction index, as in the elf.txt "# proc" lines;
+        0 is the main program)
+Notes:
+- The header lines and the stack column always reflect the whole run;
+  filters only choose which instruction lines (and their input/output
+  lines) are printed
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm0trace.h"
+// Records read per block
+#define READ_BLOCK (1 << 15)
+TraceHeader h;
+int32_t *procOf;
+int *pas;
+TraceRecord records[READ_BLOCK];
+// Mnemonic of an operation as the VM prints it
+const char *mnemonic(int op, int m)
+{
+    static const char *ops[] = {"Invalid Operation", "LIT", "OPR", "LOD", "STO", "CAL", "INC", "JMP", "JPC", "SYS", "TCL"};
+    static const char *oprs[] = {"RTN", "ADD", "SUB", "MUL", "DIV", "EQL", "NEQ", "LSS", "LEQ", "GTR", "GEQ", "EVEN"};
+    if (op == 2)
+        return (m >= 0 && m <= 11) ? oprs[m] : "OPR";
+    return (op >= 0 && op <= 10) ? ops[op] : "?";
+}
+// Print the stack from its top down to sp with '|' before the current AR
+void printStack(int bp, int sp)
+{
+    for (int i = h.stackTop; i >= sp; i--)
+    {
+        if (i == bp && i != sp && bp != h.stackTop)
+            fputs("| ", stdout);
+        printf("%2d ", pas[i]);
+    }
+    putchar('\n');
+}
+int main(int argc, char *argv[])
+{
+    // Handle the Command Line
+    const char *path = NULL;
+    long lo = -1, hi = -1, proc = -1;
+    int badArgs = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pc") == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%ld:%ld", &lo, &hi) != 2 || lo > hi)
+                badArgs = 1;
+        }
+        else if (strcmp(argv[i], "--proc") == 0 && i + 1 < argc)
+            proc = atol(argv[++i]);
+        else if (!path && argv[i][0] != '-')
+            path = argv[i];
+        else
+            badArgs = 1;
+    }
+    if (badArgs || !path)
+    {
+        printf("Usage: ./pm0trace [--pc <lo>:<hi>] [--proc <entry>] trace.bin\n");
+        return 1;
+    }
+    FILE *in = fopen(path, "rb");
+    if (!in)
+    {
+        printf("Error: cannot open trace file\n");
+        return 1;
+    }
+    // Header, procedure map and the initial stack cells
+    if (fread(&h, sizeof(h), 1, in) != 1 || memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != TRACE_VERSION || (h.codeWidth != 1 && h.codeWidth != 3) || h.pasSize <= 0 || h.codeLen <= 0 || h.stackTop < 0 || h.stackTop >= h.pasSize)
+    {
+        printf("Error: not a PM/0 trace file\n");
+        return 1;
+    }
+    procOf = malloc((size_t)h.codeLen * sizeof(int32_t));
+    pas = calloc((size_t)h.pasSize, sizeof(int));
+    if (!procOf || !pas)
+    {
+        printf("Error: out of memory\n");
+        return 1;
+    }
+    if (fread(procOf, sizeof(int32_t), (size_t)h.codeLen, in) != (size_t)h.codeLen ||
+        fread(pas, sizeof(int), (size_t)h.stackTop + 1, in) != (size_t)h.stackTop + 1)
+    {
+        printf("Error: truncated trace file\n");
+        return 1;
+    }
+    static char outBuf[1 << 16];
+    setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+    printf(" L M PC BP SP stack\n");
+    printf("Initial values : %d %d %d\n", h.pc, h.bp, h.sp);
+    // Replay the records: apply each written cell, then print the line if it is kept
+    int bp = h.bp;
+    size_t n;
+    while ((n = fread(records, sizeof(TraceRecord), READ_BLOCK, in)) > 0)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            TraceRecord *r = &records[k];
+            if (r->op == 5 && r->bp >= 2)
+            {
+                pas[r->bp - 1] = bp;       // dynamic link
+                pas[r->bp - 2] = r->at - h.codeWidth; // return address
+            }
+            if (r->cell >= 0 && r->cell < h.pasSize)
+                pas[r->cell] = r->value;
+            bp = r->bp;
+            int instr = (h.pasSize - 1 - r->at) / h.codeWidth;
+            if ((lo >= 0 && (r->at < lo || r->at > hi)) ||
+                (proc >= 0 && (instr < 0 || instr >= h.codeLen || procOf[instr] != proc)))
+                continue;
+            // Input and output lines come before the instruction's trace line
+            if (r->op == 9)
+            {
+                if (r->m == 1)
+                    printf("Output result is : %d\n", pas[r->sp - 1]);
+                else if (r->m == 2)
+                {
+                    fputs("Please Enter an Integer : ", stdout);
+                    if (r->flags & TRACE_BAD_INPUT)
+                        printf("Error: invalid input\n");
+                }
+                else if (r->m != 3)
+                    printf("Invalid SYS M: %d\n", r->m);
+            }
+            else if (r->op == 2 && (r->m < 0 || r->m > 11))
+                printf("Invalid M input\n");
+            printf("%-7s %3d %9d %5d %5d %5d ", mnemonic(r->op, r->m), r->l, r->m, r->pc, r->bp, r->sp);
+            printStack(r->bp, r->sp);
+        }
+    }
+    fclose(in);
+    return 0;
+}
@@ -0,0 +1,39 @@
+/*
+Binary execution trace shared by vm.c (writer, ./vm --trace-bin) and
+pm0trace.c (reader). A trace file is:
+- a TraceHeader
+- procOf: codeLen int32 values, the entry instruction of the procedure
+  owning each instruction (-1 if unreachable)
+- the cells pas[0 .. stackTop] before the first instruction
+- one TraceRecord per executed instruction, up to the end of the file
+Records only carry the cell an instruction wrote. CAL also writes the
+dynamic link (the BP before the call) and the return address (the
+instruction after it). Both follow from the previous record, so a CAL
+record carries only the static link.
+*/
+#ifndef PM0TRACE_H
+#define PM0TRACE_H
+#include <stdint.h>
+#define TRACE_MAGIC "PM0TRCE"
+#define TRACE_VERSION 2
+// Record flags
+#define TRACE_BAD_INPUT 1 // SYS 2 failed to read an integer; the VM halted
+typedef struct
+{
+    char magic[8]; // TRACE_MAGIC
+    int32_t version;
+    int32_t pasSize, codeLen, stackTop;
+    int32_t codeWidth;  // cells per instruction: 3 (triples) or 1 (packed)
+    int32_t pc, bp, sp; // registers before the first instruction
+} TraceHeader;
+// 32 bytes per executed instruction
+typedef struct
+{
+    int32_t at;          // code address of the instruction
+    int32_t m;
+    int32_t pc, bp, sp;  // registers after it
+    int32_t cell, value; // cell written (-1 if none) and its new value
+    uint8_t op, flags;
+    uint16_t l;
+} TraceRecord;
+#endif
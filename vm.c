@@ -10,13 +10,61 @@ gcc -O2 -std=c11 -o lex lex.c
 Parser/Code Generator:
 gcc -O2 -std=c11 -o parsercodegen_complete parsercodegen_complete.c
 Virtual Machine:
-gcc -O2 -std=c11 -o vm vm.c
+gcc -O2 -std=c11 -pthread -o vm vm.c
 To Execute (on Eustis):
 ./lex <input_file.txt>
 ./parsercodegen_complete
-./vm elf.txt
+./vm [--batch] [--input <file>] [--memory <cells>] [--exact-stack]
+     [--checkpoint <file> [--checkpoint-every <n>]]
+     [--max-steps <n>] [--timeout <seconds>]
+     [--debug-info <file>] [--profile] [--trace-bin <file>]
+     [--metrics-fd <fd>] [--record <file> | --replay <file>] elf.txt|elf.bin
+./vm --debug [--input <file> | --replay <file>] [--record <file>] [--max-steps <n>]
+     [--timeout <seconds>] [--memory <cells>] [--exact-stack] [--debug-info <file>]
+     elf.txt|elf.bin
+./vm [options] --restore <snapshot>
+./vm --sessions <socket> [--threads <n>] [--quantum <n>] [--max-steps <n>]
+     [--memory <cells>] [--exact-stack] [--debug-info <file>] elf.txt|elf.bin
+./vm --lanes <file> [--max-steps <n>] [--memory <cells>] [--exact-stack]
+     [--debug-info <file>] elf.txt|elf.bin
 where:
 <input_file.txt> is the path to the PL/0 source program
+--batch   non-interactive mode: no prompts, no trace, buffered output,
+          runs the verified program in the check-free fast interpreter
+--input   read SYS 2 input from <file> instead of stdin (batch mode)
+--memory  size of the address space in cells (default 500)
+--exact-stack  size the address space to the code plus the stack the
+          object header declares, instead of --memory
+--checkpoint  write a snapshot of the machine to <file> on SIGUSR1, every
+          <n> instructions with --checkpoint-every, and on SIGTERM (then exit 75)
+--restore resume from a snapshot; give it the same input as the original run
+--max-steps  stop (exit 3) once <n> instructions have run
+--timeout stop (exit 4) after <seconds> of wall-clock time
+--debug-info  source line table from ./parsercodegen -g (default: elf.dbg
+          next to elf.txt, if present); errors then name the source line
+--profile count executed instructions and print them per source line
+          to stderr at exit
+--trace-bin  write the execution trace to <file> in binary instead of
+          printing it; ./pm0trace turns it back into the text trace
+--metrics-fd  when the run ends (halt, error, limit or SIGTERM/SIGINT),
+          write a JSON record of run metrics to file descriptor <fd>
+--sessions  serve the program on a Unix domain socket: every connection
+          runs its own instance, reading SYS 2 input from the connection and
+          writing SYS 1 output to it, until the program halts
+--threads worker threads that run session instances (default 2)
+--quantum instructions an instance runs before another gets the thread
+          (default 10000; checked at calls and backward jumps)
+--record  write every SYS 2 value read, with a hash of the program, to the
+          input log <file> when the run ends
+--replay  batch run reading SYS 2 input from the input log <file>; exits 5
+          if the program reads more or fewer values than were recorded
+--debug   stop before the first instruction and take debugger commands
+          (break, delete, step, continue, frame, stack, quit) on stdin;
+          the program runs in the fast interpreter between stops
+--lanes   run one instance per line of <file>, the line being its SYS 2
+          input, all in lock-step; prints each instance's output on one line
+elf.bin   a packed program (./parsercodegen --packed or ./pm0pack, see
+          pm0pack.h) is recognized by its magic and run as packed words
 Notes:
 - lex.c accepts ONE command-line argument (input PL/0 source file)
 - parsercodegen_complete.c accepts NO command-line arguments
@@ -25,17 +73,41 @@ Notes:
 - Supports procedures, call statements, and if-then-else
 - Generates PM/0 assembly code (see Appendix A for ISA)
 - VM must support EVEN instruction (OPR 0 11)
+- Programs are verified once after loading and rejected if unsafe
 - All development and testing performed on Eustis
 Class: COP3402 - System Software - Fall 2025
 Instructor: Dr. Jie Lin
 Due Date: Friday, November 21, 2025 at 11:59 PM ET
 */
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
-// Define fixed size
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "pm0trace.h"
+#include "pm0pack.h"
+// Default address space size
 #define MAX_PAS 500
-// Process Address Space
-int pas[MAX_PAS];
+// Process Address Space (PAS_SIZE cells, code at the top)
+int *pas;
+int PAS_SIZE = MAX_PAS;
+// Worst-case stack cells from the object header (# stack N), -1 if unknown
+int headerStack = -1;
 // Global operation Names
 char *operationNames[] = {
     "Invalid Operation", // 0 (invalid)
@@ -47,7 +119,8 @@ char *operationNames[] = {
     "INC",               // 6
     "JMP",               // 7
     "JPC",               // 8
-    "SYS"                // 9
+    "SYS",               // 9
+    "TCL"                // 10
 };
 // Registers
 int PC, BP, SP;
@@ -57,78 +130,2864 @@ struct
 {
     int OP, L, M;
 } IR;
+// Number of instructions loaded
+int codeLen = 0;
+// Cells per instruction: 3 for op L M triples, 1 for packed words (pm0pack.h).
+// Packed code keeps its wide (L, M) pairs just below the instructions.
+int codeWidth = 3;
+int wideCount = 0;
+int codeCells = 0; // whole code segment: instructions plus wide pairs
+// Verifier results, indexed by instruction number (codeLen entries)
+int *procOf;    // entry instruction of the owning procedure, -1 if unreached
+int *depthAt;   // frame depth (cells from BP down to SP) before the instruction
+// Verifier results, indexed by a procedure's entry instruction
+int *staticDepth;   // lexical depth (main = 0)
+int *staticParent;  // entry of the enclosing procedure
+int *maxDepth;      // deepest frame extent reached
+int *minCallDepth;  // shallowest frame depth at any of its CALs
+// Frame cells the callee of a CAL/TCL needs, indexed by the op's address
+int *callNeed;
+// Instructions executed and SYS 2 values read so far
+long long steps = 0;
+long long inputCount = 0;
+// Checkpointing: snapshot file, interval, and the step count of the next one
+const char *checkpointPath = NULL;
+long long checkpointEvery = 0;
+long long nextCheckpoint = LLONG_MAX;
+// Step count at which the next safepoint does work (earliest pending deadline)
+long long safepointAt = LLONG_MAX;
+// Set from signal handlers, polled at safepoints (signalPending: any of them)
+volatile sig_atomic_t signalPending = 0;
+volatile sig_atomic_t snapshotRequested = 0;
+volatile sig_atomic_t stopRequested = 0; // the signal that asked to stop
+volatile sig_atomic_t timedOut = 0;
+// Limits for untrusted programs (0 = none)
+long long maxSteps = 0;
+double timeoutSeconds = 0;
+// Exit status when a limit stops the program
+#define EXIT_STEP_LIMIT 3
+#define EXIT_TIMEOUT 4
+// Exit status when a replayed run reads more or fewer inputs than were recorded
+#define EXIT_DIVERGED 5
+// Exit status after a SIGTERM checkpoint (EX_TEMPFAIL: rerun with --restore)
+#define EXIT_PREEMPTED 75
+/*
+Snapshot file: this header followed by the PAS_SIZE cells of pas[].
+The header is a multiple of 8 bytes so the cells can be mapped in place.
+*/
+typedef struct
+{
+    char magic[8]; // "PM0SNAP"
+    int version;
+    int pasSize, codeLen, stackTop;
+    int pc, bp, sp;
+    long long steps;
+    long long inputPos;   // batch input bytes consumed
+    long long inputCount; // SYS 2 values read
+    int codeWidth, wideCount; // version 2 (version 1 snapshots hold triples)
+} SnapshotHeader;
+/*
+Input log (--record, --replay): this header, then count SYS 2 values, each a
+zigzag varint (7 bits a byte, low bits first), so small values take one byte.
+programHash is FNV-1a over the decoded (OP, L, M) of every instruction, with
+jump and call targets as instruction numbers, so a program and its packed
+form share logs.
+*/
+typedef struct
+{
+    char magic[8]; // "PM0INPT"
+    int version;
+    int flags; // INPUT_LOG_BAD_END: the next SYS 2 found no valid integer
+    long long count;
+    unsigned long long programHash;
+} InputLogHeader;
+#define INPUT_LOG_BAD_END 1
+const char *recordPath = NULL;
+int *inputLog = NULL; // values recorded so far, or the values to replay
+long long inputLogLen = 0, inputLogCap = 0;
+int inputLogFlags = 0;
+int replaying = 0;
+long long replayPos = 0; // next value to replay
+// Source line of each instruction (from the .dbg file), NULL if unknown
+int *lineOf = NULL;
+// Execution counts per code address (--profile), NULL when not profiling
+long long *profile = NULL;
+// Binary trace (--trace-bin): records collect here and are written a block at a time
+#define TRACE_BLOCK (1 << 15)
+int traceFd = -1;
+TraceRecord *traceBuf = NULL;
+int traceLen = 0;
+// Run metrics (--metrics-fd): counted by the interpreters only when enabled,
+// written as one JSON record when the run ends
+int metricsFd = -1;
+int runError = 0; // the checked interpreter halted on an error
+struct
+{
+    long long ops[16];             // instructions by opcode (batch mode: 0 counts packed escapes)
+    long long returns;             // OPR 0
+    long long baseCalls, baseHops; // static link walks (L > 0) and links followed
+    long long outputs;             // SYS 1
+    long long startSteps, startInputs;
+    int depth, maxDepth;           // call depth (CAL minus RTN) and its maximum
+    int minSP;                     // lowest SP reached
+    struct timespec start;
+} metrics;
+// Sessions (--sessions): every connection runs its own instance of the program
+// as a task with its own stack segment and registers, on a few worker threads
+#define TASK_YIELD -1      // runTask(): the quantum ran out
+#define TASK_WAIT_INPUT -2 // runTask(): SYS 2 needs input that has not arrived yet
+#define TASK_OUT_LIMIT (1 << 16) // unsent output that parks a task until it drains
+typedef struct Task
+{
+    int pc, bp, sp;
+    long long steps;
+    int *mem;                      // stack segment: addresses 0 .. STACK_TOP, as in pas
+    int fd;                        // the session's connection
+    char *in, *out;                // input not yet read by SYS 2; output not yet sent
+    size_t inLen, inPos, inCap, outLen, outSent, outCap;
+    int inEof, needInput, done, hungUp;
+    struct Task *next;
+} Task;
+typedef struct
+{
+    pthread_mutex_t lock;
+    Task *head, *tail;
+} RunQueue;
+int sessionThreads = 2;
+long long quantum = 10000;
+RunQueue *runQueues;
+// readyTasks counts tasks in the run queues; a worker reserves one before it takes it
+pthread_mutex_t schedLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t schedReady = PTHREAD_COND_INITIALIZER;
+int readyTasks = 0, schedStop = 0;
+// Tasks handed to the I/O loop: waiting for input or for output to drain, or done
+pthread_mutex_t parkLock = PTHREAD_MUTEX_INITIALIZER;
+Task *parked = NULL;
+int wakeFds[2] = {-1, -1};
+// Lock-step lanes (--lanes): one instance of the program per input line, run
+// together. Instances at the same place form a group that executes each
+// instruction once for all of its lanes. Cell a of lane k is
+// laneCells[a * laneCount + k], so one cell of a group's lanes is contiguous.
+typedef struct
+{
+    int pc, bp, sp;
+    int *lanes; // lane numbers, ascending
+    int count;
+} LaneGroup;
+typedef struct
+{
+    int *vals; // SYS 1 values
+    int n, cap;
+    char *end; // why the lane stopped early, NULL if it halted
+} LaneOut;
+int laneCount = 0;
+int *laneCells;
+long long *laneSteps;
+int *laneIn, *laneInStart, *laneInCount, *laneInPos; // SYS 2 values, by lane
+LaneOut *laneOut;
+char *laneMark; // lanes an instruction splits off
+char *laneJoin; // code addresses where diverged groups can meet again
+LaneGroup *laneWaiting; // groups not running, each at its own place
+int laneWaitingCount = 0, laneWaitingCap = 0;
+// Debugger (--debug): a breakpoint patches its instruction into a trap, op 0
+// (the packed escape, which the verifier never lets through in triples) with
+// M = TRAP_M, no wide entry. The fast interpreter only tests for it on the
+// escape path, so it runs the program unchanged until it reaches a trap.
+#define TRAP_M -1
+#define RUN_BREAK -1 // runFast(): stopped at a trap, or by SIGINT in the debugger
+int debugging = 0;
+volatile sig_atomic_t debugBreak = 0;
+int trapped = 0; // runFast() stopped at a trap, which it counted as an instruction
+char *breakAt;             // breakpoints, by instruction number
+int *patchAt, *patchCell;  // patched code addresses; their original op and M cells
+int patchCount = 0;
+// Batch mode: no prompts or trace, SYS 1/SYS 2 go through the buffers below
+int batchMode = 0;
+// Output buffer for SYS 1, flushed when full and at halt
+#define OUT_BUF_SIZE (1 << 16)
+char outBuf[OUT_BUF_SIZE];
+int outLen = 0;
+// Input for SYS 2 read so far (mapped, or read as needed) and the read position
+const char *inBuf = NULL;
+size_t inLen = 0, inPos = 0;
+// Where it comes from, opened at startup and read from on the first SYS 2
+int inFd = STDIN_FILENO;
+int inMapped = 0, inDone = 0;
+size_t inCap = 0;
 // Helper base function to follow static links
 int base(int BP, int L)
 {
-    int arb = BP;
-    while (L > 0)
+    int arb = BP;
+    while (L > 0)
+    {
+        arb = pas[arb]; // follow static link
+        L--;
+    }
+    return arb;
+}
+// Helper: base() over the stack segment mem (a session's task, or pas)
+static inline int baseIn(const int *mem, int bp, int L)
+{
+    while (L-- > 0)
+        bp = mem[bp];
+    return bp;
+}
+// Helper: decode the instruction at code address at
+void fetch(int at, int *op, int *L, int *M)
+{
+    if (codeWidth == 3)
+    {
+        *op = pas[at];
+        *L = pas[at - 1];
+        *M = pas[at - 2];
+        return;
+    }
+    int w = pas[at];
+    *op = pm0pack_op(w);
+    *L = pm0pack_l(w);
+    *M = pm0pack_m(w);
+    if (*op == PM0PACK_ESCAPE)
+    {
+        int k = PAS_SIZE - 1 - codeLen - 2 * *M;
+        *op = *L;
+        *L = pas[k];
+        *M = pas[k - 1];
+    }
+}
+// Helper: print trace of stack with AR separator
+void printStack()
+{
+    // walks from highest stack address to lowest address
+    for (int i = STACK_TOP; i >= SP; i--)
+    {
+        // put '|' before AR (after first cycle)
+        if (i == BP && i != SP && BP != STACK_TOP)
+            printf("| ");
+        printf("%2d ", pas[i]);
+    }
+    printf("\n");
+}
+// Helper: write the buffered trace records to the trace file
+void flushTrace()
+{
+    size_t len = (size_t)traceLen * sizeof(TraceRecord);
+    const char *p = (const char *)traceBuf;
+    while (traceFd >= 0 && len > 0)
+    {
+        ssize_t n = write(traceFd, p, len);
+        if (n <= 0)
+        {
+            fprintf(stderr, "Error: cannot write the trace file, trace stopped\n");
+            close(traceFd);
+            traceFd = -1;
+            break;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    traceLen = 0;
+}
+// Helper: append the record of the instruction just executed (at: its address)
+void traceStep(int at, int flags)
+{
+    TraceRecord *r = &traceBuf[traceLen];
+    int cell = -1;
+    switch (IR.OP)
+    {
+    case 1: // LIT
+    case 3: // LOD
+        cell = SP;
+        break;
+    case 2: // OPR: the result is on top, RTN writes nothing
+        if (IR.M != 0)
+            cell = SP;
+        break;
+    case 4: // STO
+        cell = base(BP, IR.L) - IR.M;
+        break;
+    case 5: // CAL: static link (dynamic link and return address are implied)
+    case 10: // TCL
+        cell = BP;
+        break;
+    case 9: // SYS 2
+        if (IR.M == 2)
+            cell = SP;
+        break;
+    }
+    r->at = at;
+    r->m = IR.M;
+    r->pc = PC;
+    r->bp = BP;
+    r->sp = SP;
+    r->cell = cell;
+    r->value = (cell >= 0) ? pas[cell] : 0;
+    r->op = (uint8_t)IR.OP;
+    r->flags = (uint8_t)flags;
+    r->l = (uint16_t)IR.L;
+    if (++traceLen == TRACE_BLOCK)
+        flushTrace();
+}
+// Helper: create the trace file and write its header, procedure map and initial stack
+int openTrace(const char *path)
+{
+    for (int i = 0; i < codeLen; i++)
+    {
+        int op, L, M;
+        fetch(PAS_SIZE - 1 - codeWidth * i, &op, &L, &M);
+        if (L > UINT16_MAX)
+        {
+            printf("Error: --trace-bin needs levels below %d\n", UINT16_MAX + 1);
+            return 0;
+        }
+    }
+    traceFd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    traceBuf = malloc(TRACE_BLOCK * sizeof(TraceRecord));
+    if (traceFd < 0 || !traceBuf)
+    {
+        printf("Error: cannot create trace file\n");
+        return 0;
+    }
+    TraceHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.pasSize = PAS_SIZE;
+    h.codeLen = codeLen;
+    h.stackTop = STACK_TOP;
+    h.codeWidth = codeWidth;
+    h.pc = PC;
+    h.bp = BP;
+    h.sp = SP;
+    int32_t *owner = malloc((size_t)codeLen * sizeof(int32_t));
+    if (!owner)
+    {
+        printf("Error: out of memory\n");
+        return 0;
+    }
+    for (int i = 0; i < codeLen; i++)
+        owner[i] = procOf[i];
+    size_t ownerSize = (size_t)codeLen * sizeof(int32_t), cellsSize = (size_t)(STACK_TOP + 1) * sizeof(int);
+    int ok = write(traceFd, &h, sizeof(h)) == (ssize_t)sizeof(h) &&
+             write(traceFd, owner, ownerSize) == (ssize_t)ownerSize &&
+             write(traceFd, pas, cellsSize) == (ssize_t)cellsSize;
+    free(owner);
+    if (!ok)
+    {
+        printf("Error: cannot write trace file\n");
+        return 0;
+    }
+    atexit(flushTrace);
+    return 1;
+}
+// Helper: write the output buffer to stdout
+void flushOutput()
+{
+    if (outLen > 0)
+        fwrite(outBuf, 1, outLen, stdout);
+    outLen = 0;
+    fflush(stdout);
+}
+// Helper: append one integer and a newline to the output buffer
+void writeInt(int value)
+{
+    // 11 digits + sign + newline always fit after a flush
+    if (outLen > OUT_BUF_SIZE - 16)
+        flushOutput();
+    char digits[12];
+    int n = 0;
+    unsigned int u = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u > 0);
+    if (value < 0)
+        outBuf[outLen++] = '-';
+    while (n > 0)
+        outBuf[outLen++] = digits[--n];
+    outBuf[outLen++] = '\n';
+}
+// Helper: read more input into inBuf; returns 0 at the end of the input.
+// A regular file is mapped whole the first time. Pipes and terminals are
+// read as SYS 2 needs them, after the output so far is flushed, so a program
+// that reads nothing never waits for input and a co-process can answer it.
+int moreInput()
+{
+    if (inDone || timedOut || stopRequested)
+        return 0; // at the end, or the run is stopping
+    struct stat st;
+    if (!inMapped && inCap == 0 && fstat(inFd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, inFd, 0);
+        if (map != MAP_FAILED)
+        {
+            inBuf = map;
+            inLen = (size_t)st.st_size;
+            inMapped = inDone = 1;
+            return 1;
+        }
+    }
+    if (inCap - inLen < 4096)
+    {
+        size_t cap = inCap ? 2 * inCap : 1 << 16;
+        char *buf = realloc((char *)inBuf, cap);
+        if (!buf)
+        {
+            fprintf(stderr, "Error: out of memory reading input\n");
+            exit(1);
+        }
+        inBuf = buf;
+        inCap = cap;
+    }
+    flushOutput();
+    ssize_t got;
+    do
+        got = read(inFd, (char *)inBuf + inLen, inCap - inLen);
+    while (got < 0 && errno == EINTR && !timedOut && !stopRequested);
+    if (got < 0 && errno == EINTR)
+        return 0;
+    if (got <= 0)
+    {
+        inDone = 1;
+        return 0;
+    }
+    inLen += (size_t)got;
+    return 1;
+}
+// Helper: open the input file (stdin if path is NULL) for moreInput()
+int openInput(const char *path)
+{
+    inFd = path ? open(path, O_RDONLY) : STDIN_FILENO;
+    return inFd >= 0;
+}
+// Helper: make the whole input available in inBuf
+int loadInput(const char *path)
+{
+    if (!openInput(path))
+        return 0;
+    while (moreInput())
+        ;
+    return 1;
+}
+// Helper: parse the next integer from inBuf, returns 0 at end or on bad input.
+// A replay takes the next recorded value instead; 0 means none is left.
+int readInt(int *value)
+{
+    if (replaying)
+    {
+        if (replayPos == inputLogLen)
+            return 0;
+        *value = inputLog[replayPos++];
+        return 1;
+    }
+    // Read more only where the buffer ends before a number does
+    do
+        while (inPos < inLen && (inBuf[inPos] == ' ' || inBuf[inPos] == '\n' ||
+                                 inBuf[inPos] == '\t' || inBuf[inPos] == '\r'))
+            inPos++;
+    while (inPos >= inLen && moreInput());
+    int negative = 0;
+    if (inPos < inLen && (inBuf[inPos] == '-' || inBuf[inPos] == '+'))
+        negative = (inBuf[inPos++] == '-');
+    if (inPos >= inLen)
+        moreInput();
+    if (inPos >= inLen || inBuf[inPos] < '0' || inBuf[inPos] > '9')
+        return 0;
+    unsigned int u = 0;
+    while ((inPos < inLen || moreInput()) && inBuf[inPos] >= '0' && inBuf[inPos] <= '9')
+        u = u * 10 + (unsigned int)(inBuf[inPos++] - '0');
+    *value = negative ? (int)(0u - u) : (int)u;
+    return 1;
+}
+// Helper: " (line N)" for the instruction at code address addr, or ""
+const char *sourceAt(int addr)
+{
+    static _Thread_local char where[32]; // session tasks report errors from several threads
+    int i = (PAS_SIZE - 1 - addr) / codeWidth;
+    where[0] = '\0';
+    if (lineOf && addr <= PAS_SIZE - 1 && i >= 0 && i < codeLen && lineOf[i] > 0)
+        snprintf(where, sizeof(where), " (line %d)", lineOf[i]);
+    return where;
+}
+// Helper: report why the program was rejected
+int verifyFail(int i, const char *why)
+{
+    printf("Error: verification failed at instruction %d%s: %s\n", i, sourceAt(PAS_SIZE - 1 - codeWidth * i), why);
+    return 0;
+}
+// Helper: static ancestor of procedure e, L levels up
+int ancestor(int e, int L)
+{
+    while (L-- > 0)
+        e = staticParent[e];
+    return e;
+}
+// Helper: record that procedure e calls t with level difference L.
+// The callee's static parent must be the same at every call site.
+int linkCallee(int i, int e, int L, int t, int *queue, int *queueLen)
+{
+    int parent = ancestor(e, L); // CAL's static link is base(bp, L)
+    if (procOf[t] != -1 && procOf[t] != t)
+        return verifyFail(i, "call target is inside another procedure");
+    if (procOf[t] == -1)
+    {
+        procOf[t] = t;
+        depthAt[t] = 0;
+        staticParent[t] = parent;
+        staticDepth[t] = staticDepth[parent] + 1;
+        maxDepth[t] = 0;
+        minCallDepth[t] = INT_MAX;
+        queue[(*queueLen)++] = t;
+    }
+    else if (staticParent[t] != parent)
+        return verifyFail(i, "procedure is called with inconsistent static links");
+    return 1;
+}
+/*
+Load-time verifier. Checks opcodes, OPR and SYS codes, that jumps and
+calls land on instructions, that every procedure reaches each instruction
+with one frame depth, that operands never reach into the three link cells,
+that LOD/STO stay inside live frames and that static links stay on the
+chain. After it succeeds the fast interpreter runs without checks except
+one stack-space test per call, since recursion depth is not static.
+*/
+int verifyProgram()
+{
+    int n = codeLen + 1;
+    int *queue = malloc(n * sizeof(int)), *work = malloc(n * sizeof(int));
+    procOf = malloc(n * sizeof(int));
+    depthAt = malloc(n * sizeof(int));
+    staticDepth = malloc(n * sizeof(int));
+    staticParent = malloc(n * sizeof(int));
+    maxDepth = malloc(n * sizeof(int));
+    minCallDepth = malloc(n * sizeof(int));
+    callNeed = calloc(PAS_SIZE, sizeof(int));
+    if (!queue || !work || !procOf || !depthAt || !staticDepth || !staticParent || !maxDepth || !minCallDepth || !callNeed)
+        return verifyFail(0, "out of memory");
+    int queueLen = 0;
+    // Per-instruction operand checks
+    for (int i = 0; i < codeLen; i++)
+    {
+        int op, L, M;
+        fetch(PAS_SIZE - 1 - codeWidth * i, &op, &L, &M);
+        procOf[i] = -1;
+        if (op < 1 || op > 10)
+            return verifyFail(i, "invalid opcode");
+        if (L < 0 || ((op == 1 || op == 2 || op == 6 || op == 7 || op == 8 || op == 9) && L != 0))
+            return verifyFail(i, "invalid level");
+        if (op == 2 && (M < 0 || M > 11))
+            return verifyFail(i, "invalid OPR code");
+        if (op == 9 && (M < 1 || M > 3))
+            return verifyFail(i, "invalid SYS code");
+        if ((op == 5 || op == 7 || op == 8 || op == 10) && (M < 0 || M % codeWidth != 0 || M / codeWidth >= codeLen))
+            return verifyFail(i, "jump or call target is not an instruction");
+        if ((op == 3 || op == 4 || op == 6) && M < 0)
+            return verifyFail(i, "negative offset");
+        if (op == 10 && L == 0)
+            return verifyFail(i, "tail call with L = 0 would discard the callee's static parent");
+    }
+    if (codeLen == 0)
+        return verifyFail(0, "empty program");
+    // Main program: entry 0, lexical depth 0
+    procOf[0] = 0;
+    depthAt[0] = 0;
+    staticDepth[0] = 0;
+    staticParent[0] = 0;
+    maxDepth[0] = 0;
+    minCallDepth[0] = INT_MAX;
+    queue[queueLen++] = 0;
+    // Procedures in discovery order, so ancestors finish before their descendants
+    for (int q = 0; q < queueLen; q++)
+    {
+        int e = queue[q];
+        int top = 0;
+        work[top++] = e;
+        while (top > 0)
+        {
+            int i = work[--top];
+            int op, L, M;
+            fetch(PAS_SIZE - 1 - codeWidth * i, &op, &L, &M);
+            int d = depthAt[i];
+            int nd = d, succ[2], ns = 0;
+            // Everything but INC and JMP needs the link cells allocated first
+            if (op != 6 && op != 7 && d < 3)
+                return verifyFail(i, "operand stack reaches into the frame's link cells");
+            if ((op == 3 || op == 4 || op == 5 || op == 10) && L > staticDepth[e])
+                return verifyFail(i, "level is deeper than the static chain");
+            switch (op)
+            {
+            case 1: // LIT
+                nd = d + 1;
+                succ[ns++] = i + 1;
+                break;
+            case 2: // OPR
+                if (M == 0)
+                {
+                    if (e == 0)
+                        return verifyFail(i, "RTN in the main program");
+                    break;
+                }
+                if (M == 11 ? d < 4 : d < 5)
+                    return verifyFail(i, "operand stack underflow");
+                nd = (M == 11) ? d : d - 1;
+                succ[ns++] = i + 1;
+                break;
+            case 3: // LOD
+            case 4: // STO
+                if (op == 4 && d < 4)
+                    return verifyFail(i, "operand stack underflow");
+                if (op == 4 && M < 3)
+                    return verifyFail(i, "store into a frame's link cells");
+                if (L == 0 ? M >= d : M >= minCallDepth[ancestor(e, L)])
+                    return verifyFail(i, "frame offset outside the live frame");
+                nd = (op == 3) ? d + 1 : d - 1;
+                succ[ns++] = i + 1;
+                break;
+            case 5: // CAL
+            case 10: // TCL
+                if (d < minCallDepth[e])
+                    minCallDepth[e] = d;
+                if (!linkCallee(i, e, L, M / codeWidth, queue, &queueLen))
+                    return 0;
+                callNeed[PAS_SIZE - 1 - codeWidth * i] = -1; // filled in once the callee is analyzed
+                if (op == 5)
+                    succ[ns++] = i + 1;
+                break;
+            case 6: // INC
+                nd = d + M;
+                succ[ns++] = i + 1;
+                break;
+            case 7: // JMP
+                succ[ns++] = M / codeWidth;
+                break;
+            case 8: // JPC
+                if (d < 4)
+                    return verifyFail(i, "operand stack underflow");
+                nd = d - 1;
+                succ[ns++] = i + 1;
+                succ[ns++] = M / codeWidth;
+                break;
+            case 9: // SYS
+                if (M == 1 && d < 4)
+                    return verifyFail(i, "operand stack underflow");
+                if (M != 3)
+                    succ[ns++] = i + 1;
+                nd = (M == 1) ? d - 1 : (M == 2) ? d + 1 : d;
+                break;
+            }
+            if (nd > maxDepth[e])
+                maxDepth[e] = nd;
+            if (nd > PAS_SIZE)
+                return verifyFail(i, "frame larger than the address space");
+            for (int k = 0; k < ns; k++)
+            {
+                int s2 = succ[k];
+                if (s2 >= codeLen)
+                    return verifyFail(i, "execution falls off the end of the code");
+                if (procOf[s2] == -1)
+                {
+                    procOf[s2] = e;
+                    depthAt[s2] = nd;
+                    work[top++] = s2;
+                }
+                else if (procOf[s2] != e)
+                    return verifyFail(i, "instruction is shared between procedures");
+                else if (depthAt[s2] != nd)
+                    return verifyFail(s2, "stack depth mismatch at merge point");
+            }
+        }
+    }
+    // Every CAL/TCL knows how many cells its callee's frame can grow to
+    for (int i = 0; i < codeLen; i++)
+    {
+        int op, L, M;
+        fetch(PAS_SIZE - 1 - codeWidth * i, &op, &L, &M);
+        if (procOf[i] != -1 && (op == 5 || op == 10))
+            callNeed[PAS_SIZE - 1 - codeWidth * i] = maxDepth[M / codeWidth];
+    }
+    // The main frame has to fit below the code, and the header must not understate it
+    if (maxDepth[0] > PAS_SIZE - codeCells)
+        return verifyFail(0, "main program needs more stack than the address space has");
+    if (headerStack >= 0 && maxDepth[0] > headerStack)
+        return verifyFail(0, "object header understates the stack");
+    free(queue);
+    free(work);
+    return 1;
+}
+// Helper: write the whole machine state to checkpointPath (via a rename, so a
+// crash mid-write never leaves a torn snapshot)
+void writeSnapshot()
+{
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", checkpointPath);
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "PM0SNAP", 8);
+    h.version = 2;
+    h.pasSize = PAS_SIZE;
+    h.codeLen = codeLen;
+    h.stackTop = STACK_TOP;
+    h.pc = PC;
+    h.bp = BP;
+    h.sp = SP;
+    h.steps = steps;
+    h.inputPos = (long long)inPos;
+    h.inputCount = inputCount;
+    h.codeWidth = codeWidth;
+    h.wideCount = wideCount;
+    FILE *f = fopen(tmp, "wb");
+    if (!f || fwrite(&h, sizeof(h), 1, f) != 1 ||
+        fwrite(pas, sizeof(int), PAS_SIZE, f) != (size_t)PAS_SIZE || fclose(f) != 0)
+    {
+        fprintf(stderr, "Error: cannot write snapshot %s\n", tmp);
+        return;
+    }
+    if (rename(tmp, checkpointPath) != 0)
+        fprintf(stderr, "Error: cannot write snapshot %s\n", checkpointPath);
+}
+// Helper: map a snapshot back in. pas[] points straight into the private
+// mapping, so nothing is parsed or copied.
+int restoreSnapshot(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader))
+    {
+        printf("Error: cannot read snapshot %s\n", path);
+        return 0;
+    }
+    char *map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        printf("Error: cannot map snapshot %s\n", path);
+        return 0;
+    }
+    SnapshotHeader *h = (SnapshotHeader *)map;
+    // Version 1 headers end before codeWidth
+    size_t headerSize = (h->version == 1) ? offsetof(SnapshotHeader, codeWidth) : sizeof(SnapshotHeader);
+    if (memcmp(h->magic, "PM0SNAP", 8) != 0 || h->version < 1 || h->version > 2 ||
+        (size_t)st.st_size != headerSize + (size_t)h->pasSize * sizeof(int))
+    {
+        printf("Error: %s is not a snapshot\n", path);
+        return 0;
+    }
+    pas = (int *)(map + headerSize);
+    codeWidth = (h->version == 1) ? 3 : h->codeWidth;
+    wideCount = (h->version == 1) ? 0 : h->wideCount;
+    PAS_SIZE = h->pasSize;
+    codeLen = h->codeLen;
+    codeCells = codeWidth * codeLen + 2 * wideCount;
+    STACK_TOP = h->stackTop;
+    PC = h->pc;
+    BP = h->bp;
+    SP = h->sp;
+    steps = h->steps;
+    inputCount = h->inputCount;
+    inPos = (size_t)h->inputPos;
+    return 1;
+}
+// Helper: record which signal arrived; the run loop acts on it at a safepoint
+void onSignal(int sig)
+{
+    if (sig == SIGALRM)
+        timedOut = 1;
+    else if (sig == SIGINT && debugging)
+        debugBreak = 1;
+    else if (sig == SIGUSR1)
+        snapshotRequested = 1;
+    else
+    {
+        // SIGTERM (after a checkpoint, if enabled) or SIGINT with --metrics-fd
+        stopRequested = sig;
+        if (checkpointPath && sig == SIGTERM)
+            snapshotRequested = 1;
+    }
+    signalPending = 1;
+}
+// Helper: recompute when the next safepoint has work to do
+void scheduleSafepoint()
+{
+    safepointAt = nextCheckpoint;
+    if (maxSteps > 0 && maxSteps < safepointAt)
+        safepointAt = maxSteps;
+}
+// Helper: say where a limit stopped the program and return its exit status
+int stopSummary(int status, const char *why)
+{
+    flushOutput();
+    fprintf(stderr, "Stopped: %s after %lld instructions at PC %d (instruction %d)%s, BP %d, SP %d\n",
+            why, steps, PC, (PAS_SIZE - 1 - PC) / codeWidth, sourceAt(PC), BP, SP);
+    return status;
+}
+/*
+Safepoint, reached at calls and backward jumps (every loop passes one) once
+steps >= safepointAt or a signal is pending. Registers must be stored in
+PC/BP/SP. Returns 0 to keep running, otherwise the exit status.
+*/
+int safepoint()
+{
+    signalPending = 0;
+    if (steps >= nextCheckpoint)
+    {
+        nextCheckpoint = steps + checkpointEvery;
+        snapshotRequested = 1;
+    }
+    if (snapshotRequested)
+    {
+        snapshotRequested = 0;
+        flushOutput();
+        writeSnapshot();
+    }
+    scheduleSafepoint();
+    if (debugBreak)
+    {
+        debugBreak = 0;
+        return RUN_BREAK;
+    }
+    if (stopRequested == SIGTERM && checkpointPath)
+        return EXIT_PREEMPTED;
+    if (stopRequested)
+        return stopSummary(128 + stopRequested, "signal");
+    if (maxSteps > 0 && steps >= maxSteps)
+        return stopSummary(EXIT_STEP_LIMIT, "step limit reached");
+    if (timedOut)
+        return stopSummary(EXIT_TIMEOUT, "timeout");
+    return 0;
+}
+// Helper: hash of the loaded program, stored in input logs
+unsigned long long programHash()
+{
+    unsigned long long h = 14695981039346656037ULL; // FNV-1a
+    for (int i = 0; i < codeLen; i++)
+    {
+        int f[3];
+        fetch(PAS_SIZE - 1 - codeWidth * i, &f[0], &f[1], &f[2]);
+        if (f[0] == 5 || f[0] == 7 || f[0] == 8 || f[0] == 10)
+            f[2] /= codeWidth; // code addresses as instruction numbers
+        for (int k = 0; k < 3; k++)
+            for (int b = 0; b < 4; b++)
+            {
+                h ^= ((unsigned int)f[k] >> (8 * b)) & 0xff;
+                h *= 1099511628211ULL;
+            }
+    }
+    return h;
+}
+// Helper: add one SYS 2 value to the input log (--record)
+void recordInput(int value)
+{
+    if (inputLogLen == inputLogCap)
+    {
+        long long cap = inputLogCap ? 2 * inputLogCap : 1024;
+        int *grown = realloc(inputLog, (size_t)cap * sizeof(int));
+        if (!grown)
+        {
+            fprintf(stderr, "Error: out of memory recording input\n");
+            exit(1);
+        }
+        inputLog = grown;
+        inputLogCap = cap;
+    }
+    inputLog[inputLogLen++] = value;
+}
+// Helper: write the input log to recordPath (via a rename, as snapshots are)
+void writeInputLog()
+{
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", recordPath);
+    InputLogHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "PM0INPT", 8);
+    h.version = 1;
+    h.flags = inputLogFlags;
+    h.count = inputLogLen;
+    h.programHash = programHash();
+    FILE *f = fopen(tmp, "wb");
+    int ok = f && fwrite(&h, sizeof(h), 1, f) == 1;
+    for (long long i = 0; ok && i < inputLogLen; i++)
+    {
+        unsigned int z = ((unsigned int)inputLog[i] << 1) ^ (unsigned int)(inputLog[i] >> 31);
+        while (z >= 0x80)
+        {
+            putc((int)(z & 0x7f) | 0x80, f);
+            z >>= 7;
+        }
+        ok = putc((int)z, f) != EOF;
+    }
+    if (f && fclose(f) != 0)
+        ok = 0;
+    if (!ok || rename(tmp, recordPath) != 0)
+        fprintf(stderr, "Error: cannot write input log %s\n", recordPath);
+}
+// Helper: load an input log for replay; it must come from the loaded program
+int loadInputLog(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        printf("Error: cannot read input log %s\n", path);
+        return 0;
+    }
+    InputLogHeader h;
+    int ok = fread(&h, sizeof(h), 1, f) == 1 && memcmp(h.magic, "PM0INPT", 8) == 0 && h.version == 1 &&
+             h.count >= 0 && h.count <= INT_MAX;
+    inputLog = ok ? malloc((size_t)h.count * sizeof(int) + 1) : NULL;
+    for (long long i = 0; inputLog && i < h.count; i++)
+    {
+        unsigned int z = 0;
+        int c = 0x80;
+        for (int shift = 0; shift < 35 && (c & 0x80); shift += 7)
+        {
+            if ((c = getc(f)) == EOF)
+                break;
+            z |= (unsigned int)(c & 0x7f) << shift;
+        }
+        if (c == EOF || (c & 0x80))
+        {
+            free(inputLog);
+            inputLog = NULL;
+        }
+        else
+            inputLog[i] = (int)(z >> 1) ^ -(int)(z & 1);
+    }
+    fclose(f);
+    if (!inputLog)
+    {
+        printf("Error: %s is not an input log\n", path);
+        return 0;
+    }
+    if (h.programHash != programHash())
+    {
+        printf("Error: input log %s was recorded from a different program\n", path);
+        return 0;
+    }
+    inputLogLen = h.count;
+    inputLogFlags = h.flags;
+    return 1;
+}
+// Helper: report a replay that reads past the recorded inputs at code address at
+int replayDiverged(int at)
+{
+    fprintf(stderr, "Error: replay diverged: the program reads input %lld%s, but the log holds %lld\n",
+            inputCount + 1, sourceAt(at), inputLogLen);
+    return EXIT_DIVERGED;
+}
+// Helper: make room for n more bytes in a session buffer; returns 0 when out of memory
+int taskReserve(char **buf, size_t *cap, size_t len, size_t n)
+{
+    if (len + n <= *cap)
+        return 1;
+    size_t want = *cap ? *cap : 256;
+    while (want < len + n)
+        want *= 2;
+    char *grown = realloc(*buf, want);
+    if (!grown)
+        return 0;
+    *buf = grown;
+    *cap = want;
+    return 1;
+}
+// Helper: append formatted text to a task's output (SYS 1 and error messages)
+void taskPrintf(Task *t, const char *fmt, ...)
+{
+    char text[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return;
+    if (n >= (int)sizeof(text))
+        n = sizeof(text) - 1;
+    if (taskReserve(&t->out, &t->outCap, t->outLen, (size_t)n))
+    {
+        memcpy(t->out + t->outLen, text, (size_t)n);
+        t->outLen += (size_t)n;
+    }
+}
+// Helper: SYS 1 for a task, one integer per line as in batch mode
+void taskWriteInt(Task *t, int value)
+{
+    if (!taskReserve(&t->out, &t->outCap, t->outLen, 16))
+        return;
+    t->outLen += (size_t)sprintf(t->out + t->outLen, "%d\n", value);
+}
+// Helper: SYS 2 for a task, parsed as readInt() does. Returns 1 with the value,
+// 0 on bad input or the end of the input, -1 if the number may still be arriving
+int taskReadInt(Task *t, int *value)
+{
+    size_t pos = t->inPos, len = t->inLen;
+    const char *in = t->in;
+    while (pos < len && (in[pos] == ' ' || in[pos] == '\n' || in[pos] == '\t' || in[pos] == '\r'))
+        pos++;
+    t->inPos = pos;
+    int negative = 0;
+    if (pos < len && (in[pos] == '-' || in[pos] == '+'))
+        negative = (in[pos++] == '-');
+    if (pos >= len)
+        return t->inEof ? 0 : -1;
+    if (in[pos] < '0' || in[pos] > '9')
+        return 0;
+    unsigned int u = 0;
+    while (pos < len && in[pos] >= '0' && in[pos] <= '9')
+        u = u * 10 + (unsigned int)(in[pos++] - '0');
+    if (pos == len && !t->inEof)
+        return -1;
+    t->inPos = pos;
+    *value = negative ? (int)(0u - u) : (int)u;
+    return 1;
+}
+// Helper: report a runtime error of runFastWidth() on stderr, or in the
+// task's output for a session; returns 1
+int fastError(Task *t, const char *what, int at)
+{
+    if (t)
+        taskPrintf(t, "Error: %s%s\n", what, sourceAt(at));
+    else
+    {
+        flushOutput();
+        fprintf(stderr, "Error: %s%s\n", what, sourceAt(at));
+    }
+    return 1;
+}
+// Force inlining, so each call of runFastWidth() below compiles to its own loop
+#if defined(__GNUC__)
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE static inline
+#endif
+// Fast interpreter for verified programs: no trace, no checks except stack
+// space at calls and the divisor of DIV. In batch mode (task NULL) it runs
+// the machine's registers and returns 0 on halt or 1 on a runtime error.
+// With a session's task (--sessions) it runs that task's registers and stack
+// segment against the shared code for at most one quantum, reports errors in
+// the task's output, and also returns TASK_YIELD at the end of the quantum or
+// TASK_WAIT_INPUT when SYS 2 must wait for more input.
+// width is codeWidth, metered is 1 with --metrics-fd and task is NULL outside
+// sessions, all passed as constants so each call compiles to its own loop and
+// a run without metrics counts nothing.
+ALWAYS_INLINE int runFastWidth(const int width, const int metered, Task *const task)
+{
+    int pc = task ? task->pc : PC, bp = task ? task->bp : BP, sp = task ? task->sp : SP;
+    int *p = task ? task->mem : pas;
+    const int *code = task ? pas : p;
+    // Stores through p may alias these globals: copies keep them in registers
+    const int top = PAS_SIZE - 1, wide = PAS_SIZE - 1 - codeLen;
+    long long count = task ? task->steps : steps;
+    long long sliceEnd = count + quantum;
+    if (task && maxSteps > 0 && maxSteps < sliceEnd)
+        sliceEnd = maxSteps;
+// Store the registers in the task or the machine, with PC at
+#define SAVE(at)                                                                 \
+    do                                                                           \
+    {                                                                            \
+        if (task)                                                                \
+            task->pc = (at), task->bp = bp, task->sp = sp, task->steps = count; \
+        else                                                                     \
+            PC = (at), BP = bp, SP = sp, steps = count;                          \
+    } while (0)
+    for (;;)
+    {
+        int at = pc;
+        count++;
+        if (!task && profile)
+            profile[at]++;
+        int op, L, m;
+        if (width == 1)
+        {
+            int w = code[at];
+            op = pm0pack_op(w);
+            L = pm0pack_l(w);
+            m = pm0pack_m(w);
+            pc = at - 1;
+        }
+        else
+        {
+            op = code[at];
+            L = code[at - 1];
+            m = code[at - 2];
+            pc = at - 3;
+        }
+    dispatch:
+        if (metered)
+            metrics.ops[op]++;
+        switch (op)
+        {
+        case 0: // escaped packed instruction: the op is in L, L and M in the wide table
+        {
+            if (!task && m == TRAP_M) // breakpoint (--debug): the patched instruction has not run
+            {
+                SAVE(at);
+                trapped = 1;
+                return RUN_BREAK;
+            }
+            int k = wide - 2 * m;
+            op = L;
+            L = code[k];
+            m = code[k - 1];
+            goto dispatch;
+        }
+        case 1: // LIT
+            p[--sp] = m;
+            break;
+        case 2: // OPR
+            switch (m)
+            {
+            case 0:
+                sp = bp + 1;
+                bp = p[sp - 2];
+                pc = p[sp - 3];
+                if (metered)
+                    metrics.returns++, metrics.depth--;
+                break;
+            case 1: p[sp + 1] = p[sp + 1] + p[sp]; sp++; break;
+            case 2: p[sp + 1] = p[sp + 1] - p[sp]; sp++; break;
+            case 3: p[sp + 1] = p[sp + 1] * p[sp]; sp++; break;
+            case 4:
+                // A division that would trap ends the program (or the task), not the VM
+                if (p[sp] == 0 || (p[sp] == -1 && p[sp + 1] == INT_MIN))
+                    goto divide;
+                p[sp + 1] = p[sp + 1] / p[sp];
+                sp++;
+                break;
+            case 5: p[sp + 1] = (p[sp + 1] == p[sp]); sp++; break;
+            case 6: p[sp + 1] = (p[sp + 1] != p[sp]); sp++; break;
+            case 7: p[sp + 1] = (p[sp + 1] < p[sp]); sp++; break;
+            case 8: p[sp + 1] = (p[sp + 1] <= p[sp]); sp++; break;
+            case 9: p[sp + 1] = (p[sp + 1] > p[sp]); sp++; break;
+            case 10: p[sp + 1] = (p[sp + 1] >= p[sp]); sp++; break;
+            case 11: p[sp] = (p[sp] % 2 == 0); break;
+            }
+            break;
+        case 3: // LOD
+        {
+            if (metered && L)
+                metrics.baseCalls++, metrics.baseHops += L;
+            p[sp - 1] = p[(L == 0 ? bp : task ? baseIn(p, bp, L) : base(bp, L)) - m];
+            sp--;
+            break;
+        }
+        case 4: // STO
+        {
+            if (metered && L)
+                metrics.baseCalls++, metrics.baseHops += L;
+            p[(L == 0 ? bp : task ? baseIn(p, bp, L) : base(bp, L)) - m] = p[sp];
+            sp++;
+            break;
+        }
+        case 5: // CAL
+        {
+            if (sp - callNeed[at] < 0)
+                goto overflow;
+            if (metered)
+            {
+                if (L)
+                    metrics.baseCalls++, metrics.baseHops += L;
+                if (++metrics.depth > metrics.maxDepth)
+                    metrics.maxDepth = metrics.depth;
+            }
+            p[sp - 1] = (L == 0) ? bp : task ? baseIn(p, bp, L) : base(bp, L);
+            p[sp - 2] = bp;
+            p[sp - 3] = pc;
+            bp = sp - 1;
+            pc = top - m;
+            // Fast path: allocate the callee's frame without dispatching its INC
+            if (width == 1 ? (code[pc] & 0xFF) == 6 : code[pc] == 6)
+            {
+                count++;
+                if (!task && profile)
+                    profile[pc]++;
+                sp -= (width == 1) ? pm0pack_m(code[pc]) : code[pc - 2];
+                pc -= width;
+                if (metered)
+                    metrics.ops[6]++;
+            }
+            goto poll;
+        }
+        case 10: // TCL
+            if (bp + 1 - callNeed[at] < 0)
+                goto overflow;
+            if (metered)
+                metrics.baseCalls++, metrics.baseHops += L;
+            p[bp] = task ? baseIn(p, bp, L) : base(bp, L);
+            sp = bp + 1;
+            pc = top - m;
+            if (width == 1 ? (code[pc] & 0xFF) == 6 : code[pc] == 6)
+            {
+                count++;
+                if (!task && profile)
+                    profile[pc]++;
+                sp -= (width == 1) ? pm0pack_m(code[pc]) : code[pc - 2];
+                pc -= width;
+                if (metered)
+                    metrics.ops[6]++;
+            }
+            goto poll;
+        case 6: // INC
+            sp -= m;
+            break;
+        case 7: // JMP
+            pc = top - m;
+            if (pc >= at)
+                goto poll;
+            break;
+        case 8: // JPC
+            sp++;
+            if (p[sp - 1] == 0)
+            {
+                pc = top - m;
+                if (pc >= at)
+                    goto poll;
+            }
+            break;
+        case 9: // SYS
+            if (m == 1)
+            {
+                if (task)
+                    taskWriteInt(task, p[sp]);
+                else
+                    writeInt(p[sp]);
+                sp++;
+                if (metered)
+                    metrics.outputs++;
+            }
+            else if (m == 2 && task)
+            {
+                int got = taskReadInt(task, &p[sp - 1]);
+                if (got < 0)
+                {
+                    // Not here yet: run this SYS 2 again once more input arrives
+                    count--;
+                    SAVE(at);
+                    return TASK_WAIT_INPUT;
+                }
+                sp--;
+                if (!got)
+                    goto badInput;
+            }
+            else if (m == 2)
+            {
+                sp--;
+                if (!readInt(&p[sp]))
+                {
+                    // A timeout or stop signal interrupts a SYS 2 still waiting
+                    // for input; a snapshot then runs the SYS 2 again
+                    if (timedOut || stopRequested)
+                    {
+                        sp++;
+                        SAVE(at);
+                        return safepoint();
+                    }
+                    SAVE(pc);
+                    flushOutput();
+                    if (replaying && !(inputLogFlags & INPUT_LOG_BAD_END))
+                        return replayDiverged(at);
+                    inputLogFlags |= INPUT_LOG_BAD_END;
+                    fprintf(stderr, "Error: invalid input%s\n", sourceAt(at));
+                    return 1;
+                }
+                inputCount++;
+                if (recordPath)
+                    recordInput(p[sp]);
+            }
+            else
+            {
+                SAVE(pc);
+                return 0;
+            }
+            break;
+        }
+        if (metered && sp < metrics.minSP)
+            metrics.minSP = sp;
+        continue;
+    // Calls and backward jumps: every loop passes here, so limits, signals
+    // and the end of a task's quantum are honoured without a test on every
+    // instruction
+    poll:
+        if (metered && sp < metrics.minSP)
+            metrics.minSP = sp;
+        if (task)
+        {
+            if (count >= sliceEnd)
+            {
+                SAVE(pc);
+                return TASK_YIELD;
+            }
+        }
+        else if (count >= safepointAt || signalPending)
+        {
+            SAVE(pc);
+            int status = safepoint();
+            if (status)
+                return status;
+        }
+        continue;
+    overflow:
+        SAVE(at);
+        return fastError(task, "stack overflow", at);
+    divide:
+        SAVE(at);
+        return fastError(task, "division by zero", at);
+    badInput:
+        SAVE(at);
+        return fastError(task, "invalid input", at);
+    }
+#undef SAVE
+}
+int runFast()
+{
+    if (metricsFd >= 0)
+        return (codeWidth == 1) ? runFastWidth(1, 1, NULL) : runFastWidth(3, 1, NULL);
+    return (codeWidth == 1) ? runFastWidth(1, 0, NULL) : runFastWidth(3, 0, NULL);
+}
+// Run one quantum of a session's task (--sessions)
+int runTask(Task *t)
+{
+    return (codeWidth == 1) ? runFastWidth(1, 0, t) : runFastWidth(3, 0, t);
+}
+// Helper: append a ready task to run queue q and wake a worker
+void pushTask(int q, Task *t)
+{
+    RunQueue *rq = &runQueues[q];
+    t->next = NULL;
+    pthread_mutex_lock(&rq->lock);
+    if (rq->tail)
+        rq->tail->next = t;
+    else
+        rq->head = t;
+    rq->tail = t;
+    pthread_mutex_unlock(&rq->lock);
+    pthread_mutex_lock(&schedLock);
+    readyTasks++;
+    pthread_cond_signal(&schedReady);
+    pthread_mutex_unlock(&schedLock);
+}
+// Helper: take the first task of a run queue, NULL if it is empty
+Task *popTask(RunQueue *rq)
+{
+    pthread_mutex_lock(&rq->lock);
+    Task *t = rq->head;
+    if (t)
+    {
+        rq->head = t->next;
+        if (!rq->head)
+            rq->tail = NULL;
+    }
+    pthread_mutex_unlock(&rq->lock);
+    return t;
+}
+// Helper: hand a task to the I/O loop
+void parkTask(Task *t)
+{
+    pthread_mutex_lock(&parkLock);
+    t->next = parked;
+    parked = t;
+    pthread_mutex_unlock(&parkLock);
+    if (write(wakeFds[1], "", 1) < 0 && errno != EAGAIN)
+        perror("write");
+}
+// Helper: send as much of a task's output as the connection takes without blocking
+void taskFlush(Task *t)
+{
+    while (t->outSent < t->outLen && !t->hungUp)
+    {
+        ssize_t w = send(t->fd, t->out + t->outSent, t->outLen - t->outSent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (w > 0)
+            t->outSent += (size_t)w;
+        else if (w < 0 && errno == EINTR)
+            continue;
+        else
+        {
+            // A client that went away reads nothing more and sends nothing more
+            if (w == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                t->hungUp = t->inEof = 1;
+            break;
+        }
+    }
+    if (t->outSent == t->outLen || t->hungUp)
+        t->outSent = t->outLen = 0;
+}
+// Helper: read what has arrived for a task waiting in SYS 2; returns 1 if it can retry
+int taskReceive(Task *t)
+{
+    if (t->inPos > 0)
+    {
+        memmove(t->in, t->in + t->inPos, t->inLen - t->inPos);
+        t->inLen -= t->inPos;
+        t->inPos = 0;
+    }
+    if (!taskReserve(&t->in, &t->inCap, t->inLen, 4096))
+        return t->inEof = 1;
+    ssize_t r = recv(t->fd, t->in + t->inLen, t->inCap - t->inLen, MSG_DONTWAIT);
+    if (r > 0)
+        t->inLen += (size_t)r;
+    else if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        t->inEof = 1;
+    else
+        return 0;
+    return 1;
+}
+// Helper: a fresh instance of the loaded program on connection fd, NULL when out of memory
+Task *newTask(int fd)
+{
+    Task *t = calloc(1, sizeof(Task));
+    if (!t || !(t->mem = calloc((size_t)STACK_TOP + 1, sizeof(int))))
+    {
+        free(t);
+        return NULL;
+    }
+    t->fd = fd;
+    t->pc = PAS_SIZE - 1;
+    t->sp = PAS_SIZE - codeCells;
+    t->bp = t->sp - 1;
+    return t;
+}
+void freeTask(Task *t)
+{
+    close(t->fd);
+    free(t->mem);
+    free(t->in);
+    free(t->out);
+    free(t);
+}
+// Worker thread: run tasks one quantum at a time, own queue first, then others'
+void *sessionWorker(void *arg)
+{
+    int self = (int)(intptr_t)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&schedLock);
+        while (readyTasks == 0 && !schedStop)
+            pthread_cond_wait(&schedReady, &schedLock);
+        if (schedStop)
+        {
+            pthread_mutex_unlock(&schedLock);
+            return NULL;
+        }
+        readyTasks--;
+        pthread_mutex_unlock(&schedLock);
+        // The reservation guarantees some queue holds a task
+        Task *t = NULL;
+        for (int i = 0; !t; i++)
+            t = popTask(&runQueues[(self + i) % sessionThreads]);
+        int status = runTask(t);
+        if (status == TASK_YIELD && maxSteps > 0 && t->steps >= maxSteps)
+        {
+            taskPrintf(t, "Stopped: step limit reached after %lld instructions%s\n", t->steps, sourceAt(t->pc));
+            status = EXIT_STEP_LIMIT;
+        }
+        t->needInput = (status == TASK_WAIT_INPUT);
+        t->done = (status >= 0);
+        taskFlush(t);
+        if (status == TASK_YIELD && t->outLen - t->outSent < TASK_OUT_LIMIT)
+            pushTask(self, t);
+        else
+            parkTask(t);
+    }
+}
+/*
+Sessions (--sessions): accept connections on a Unix domain socket and run a
+fresh instance of the loaded program for each. The connection is the
+instance's input (SYS 2) and output (SYS 1, one integer per line), and it
+is closed when the program halts. Worker threads run ready tasks; this
+thread polls the connections of tasks waiting to read or to send.
+*/
+int runSessions(const char *socketPath)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path))
+    {
+        printf("Error: socket path too long\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath);
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listenFd, 128) != 0 ||
+        pipe(wakeFds) != 0)
+    {
+        perror("Error: sessions");
+        return 1;
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+    fcntl(wakeFds[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeFds[1], F_SETFL, O_NONBLOCK);
+    // Workers leave SIGINT and SIGTERM to this thread, whose poll() they interrupt
+    sigset_t stopSignals, old;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, &old);
+    runQueues = calloc((size_t)sessionThreads, sizeof(RunQueue));
+    pthread_t *threads = calloc((size_t)sessionThreads, sizeof(pthread_t));
+    if (!runQueues || !threads)
+    {
+        printf("Error: out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < sessionThreads; i++)
+    {
+        pthread_mutex_init(&runQueues[i].lock, NULL);
+        pthread_create(&threads[i], NULL, sessionWorker, (void *)(intptr_t)i);
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    Task **waiting = NULL;
+    struct pollfd *fds = NULL;
+    size_t nWaiting = 0, capWaiting = 0;
+    int nextQueue = 0, fresh = 0;
+    while (!stopRequested)
+    {
+        for (size_t i = 0; i < nWaiting; i++)
+        {
+            Task *t = waiting[i];
+            fds[2 + i].fd = t->fd;
+            fds[2 + i].events = (t->outLen > t->outSent ? POLLOUT : 0) | (t->needInput ? POLLIN : 0);
+        }
+        if (!fds && !(fds = malloc(2 * sizeof(struct pollfd))))
+            break;
+        fds[0].fd = listenFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakeFds[0];
+        fds[1].events = POLLIN;
+        // Newly parked tasks may need no event (finished, or output already sent)
+        if (poll(fds, 2 + nWaiting, fresh ? 0 : -1) < 0)
+            continue;
+        fresh = 0;
+        // Waiting tasks: send, receive, then close, resume or keep waiting
+        size_t kept = 0;
+        for (size_t i = 0; i < nWaiting; i++)
+        {
+            Task *t = waiting[i];
+            short ev = fds[2 + i].revents;
+            int retry = 0;
+            if (ev & (POLLOUT | POLLERR | POLLHUP))
+                taskFlush(t);
+            if (t->needInput && (ev & (POLLIN | POLLERR | POLLHUP)))
+                retry = taskReceive(t);
+            if (t->done && (t->outLen == t->outSent))
+                freeTask(t);
+            else if (!t->done && (t->needInput ? retry || t->hungUp : t->outLen - t->outSent < TASK_OUT_LIMIT))
+            {
+                t->needInput = 0;
+                pushTask(nextQueue++ % sessionThreads, t);
+            }
+            else
+                waiting[kept++] = t;
+        }
+        nWaiting = kept;
+        // Tasks the workers parked since the last poll
+        if (fds[1].revents)
+        {
+            char drain[256];
+            while (read(wakeFds[0], drain, sizeof(drain)) > 0)
+                ;
+            pthread_mutex_lock(&parkLock);
+            Task *list = parked;
+            parked = NULL;
+            pthread_mutex_unlock(&parkLock);
+            for (; list; list = list->next)
+            {
+                if (nWaiting == capWaiting)
+                {
+                    capWaiting = capWaiting ? 2 * capWaiting : 64;
+                    waiting = realloc(waiting, capWaiting * sizeof(Task *));
+                    fds = realloc(fds, (capWaiting + 2) * sizeof(struct pollfd));
+                    if (!waiting || !fds)
+                    {
+                        printf("Error: out of memory\n");
+                        return 1;
+                    }
+                }
+                waiting[nWaiting++] = list;
+                fresh = 1;
+            }
+        }
+        // New sessions start ready, spread over the queues
+        if (fds[0].revents)
+        {
+            int fd;
+            while ((fd = accept(listenFd, NULL, NULL)) >= 0)
+            {
+                Task *t = newTask(fd);
+                if (t)
+                    pushTask(nextQueue++ % sessionThreads, t);
+                else
+                    close(fd);
+            }
+        }
+    }
+    // Stop: workers finish their quantum; sessions still open are dropped
+    pthread_mutex_lock(&schedLock);
+    schedStop = 1;
+    pthread_cond_broadcast(&schedReady);
+    pthread_mutex_unlock(&schedLock);
+    for (int i = 0; i < sessionThreads; i++)
+        pthread_join(threads[i], NULL);
+    close(listenFd);
+    unlink(socketPath);
+    return 0;
+}
+// Helper: count the instruction the checked interpreter just executed (--metrics-fd)
+void meterStep()
+{
+    if (IR.OP >= 0 && IR.OP < 16)
+        metrics.ops[IR.OP]++;
+    switch (IR.OP)
+    {
+    case 2: // RTN
+        if (IR.M == 0)
+            metrics.returns++, metrics.depth--;
+        break;
+    case 3: // LOD
+    case 4: // STO
+    case 10: // TCL
+        if (IR.L > 0)
+            metrics.baseCalls++, metrics.baseHops += IR.L;
+        break;
+    case 5: // CAL
+        if (IR.L > 0)
+            metrics.baseCalls++, metrics.baseHops += IR.L;
+        if (++metrics.depth > metrics.maxDepth)
+            metrics.maxDepth = metrics.depth;
+        break;
+    case 9: // SYS 1
+        if (IR.M == 1)
+            metrics.outputs++;
+        break;
+    }
+    if (SP < metrics.minSP)
+        metrics.minSP = SP;
+}
+// Helper: start counting from the current machine state (--metrics-fd)
+void startMetrics()
+{
+    memset(&metrics, 0, sizeof(metrics));
+    metrics.startSteps = steps;
+    metrics.startInputs = inputCount;
+    metrics.minSP = SP;
+    // A restored run starts inside its frames: count the dynamic links down to main
+    for (int b = BP; b != STACK_TOP && b >= 1 && b < PAS_SIZE && metrics.depth < PAS_SIZE; b = pas[b - 1])
+        metrics.depth++;
+    metrics.maxDepth = metrics.depth;
+    clock_gettime(CLOCK_MONOTONIC, &metrics.start);
+}
+// Helper: finish a run that ends with exit status status: check a replay used
+// up its inputs, write the input log and the metrics record, and return status
+int finishRun(int status)
+{
+    if (replaying && status == 0 && !runError && replayPos < inputLogLen)
+    {
+        fprintf(stderr, "Error: replay diverged: the program halted after %lld of %lld recorded inputs\n",
+                replayPos, inputLogLen);
+        status = EXIT_DIVERGED;
+    }
+    if (recordPath)
+        writeInputLog();
+    if (metricsFd < 0)
+        return status;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double ms = (now.tv_sec - metrics.start.tv_sec) * 1e3 + (now.tv_nsec - metrics.start.tv_nsec) / 1e6;
+    const char *reason = (status == 0) ? (runError ? "error" : "halt")
+                       : (status == 1) ? "error"
+                       : (status == EXIT_STEP_LIMIT) ? "step-limit"
+                       : (status == EXIT_TIMEOUT) ? "timeout"
+                       : (status == EXIT_DIVERGED) ? "diverged"
+                       : (status == EXIT_PREEMPTED) ? "preempted" : "signal";
+    char buf[2048];
+    int n = snprintf(buf, sizeof(buf), "{\"status\": %d, \"reason\": \"%s\", \"instructions\": %lld, \"ops\": {",
+                     status, reason, steps - metrics.startSteps);
+    for (int op = 1; op <= 10; op++)
+        n += snprintf(buf + n, sizeof(buf) - n, "%s\"%s\": %lld", op > 1 ? ", " : "", operationNames[op], metrics.ops[op]);
+    n += snprintf(buf + n, sizeof(buf) - n,
+                  "}, \"calls\": %lld, \"tail_calls\": %lld, \"returns\": %lld, \"max_call_depth\": %d, "
+                  "\"max_stack\": %d, \"base_calls\": %lld, \"base_hops\": %lld, \"outputs\": %lld, "
+                  "\"inputs\": %lld, \"elapsed_ms\": %.3f}\n",
+                  metrics.ops[5], metrics.ops[10], metrics.returns, metrics.maxDepth, STACK_TOP - metrics.minSP,
+                  metrics.baseCalls, metrics.baseHops, metrics.outputs, inputCount - metrics.startInputs, ms);
+    for (const char *q = buf; n > 0;)
+    {
+        ssize_t w = write(metricsFd, q, (size_t)n);
+        if (w <= 0)
+            break;
+        q += w;
+        n -= (int)w;
+    }
+    return status;
+}
+/*
+Read the line table written by ./parsercodegen -g: a "# pm0 lines" header,
+then "instruction line" pairs, each line holding until the next pair.
+A missing default file is not an error; a malformed one is.
+*/
+int loadDebugInfo(const char *path, int required)
+{
+    FILE *in = fopen(path, "r");
+    if (!in)
+    {
+        if (required)
+            printf("Error: cannot open debug info %s\n", path);
+        return !required;
+    }
+    char header[32];
+    lineOf = calloc(codeLen > 0 ? codeLen : 1, sizeof(int));
+    int ok = lineOf && fgets(header, sizeof(header), in) && strncmp(header, "# pm0 lines", 11) == 0;
+    int i, line, prev = -1, prevLine = 0;
+    while (ok && fscanf(in, "%d %d", &i, &line) == 2)
+    {
+        if (i <= prev || i >= codeLen)
+        {
+            ok = 0;
+            break;
+        }
+        for (int k = prev + 1; k < i; k++)
+            lineOf[k] = prevLine;
+        lineOf[i] = line;
+        prev = i, prevLine = line;
+    }
+    for (int k = prev + 1; ok && k < codeLen; k++)
+        lineOf[k] = prevLine;
+    fclose(in);
+    if (!ok)
+    {
+        printf("Error: %s is not a line table for this program\n", path);
+        free(lineOf);
+        lineOf = NULL;
+        return 0;
+    }
+    return 1;
+}
+// Print the --profile counts at exit, summed per source line when known
+void reportProfile()
+{
+    long long total = 0;
+    fprintf(stderr, "Profile:\n");
+    if (lineOf)
+    {
+        int maxLine = 0;
+        for (int i = 0; i < codeLen; i++)
+            if (lineOf[i] > maxLine)
+                maxLine = lineOf[i];
+        long long *perLine = calloc(maxLine + 1, sizeof(long long));
+        if (!perLine)
+            return;
+        for (int i = 0; i < codeLen; i++)
+            perLine[lineOf[i]] += profile[PAS_SIZE - 1 - codeWidth * i];
+        for (int l = 0; l <= maxLine; l++)
+        {
+            if (perLine[l] > 0)
+                fprintf(stderr, "  line %5d %12lld\n", l, perLine[l]);
+            total += perLine[l];
+        }
+        free(perLine);
+    }
+    else
+    {
+        for (int i = 0; i < codeLen; i++)
+        {
+            long long n = profile[PAS_SIZE - 1 - codeWidth * i];
+            if (n > 0)
+                fprintf(stderr, "  instr %4d %12lld\n", i, n);
+            total += n;
+        }
+    }
+    fprintf(stderr, "  total      %12lld\n", total);
+}
+// Helper: read a packed program after its header into one array laid out
+// like the code segment (words, then the wide pairs), NULL on error
+int *readPacked(FILE *in, const pm0pack_header *h)
+{
+    int32_t *words, *wide;
+    int *code = NULL;
+    if (pm0pack_read(in, h, &words, &wide))
+        code = malloc(((size_t)h->codeLen + 2 * (size_t)h->wideCount + 1) * sizeof(int));
+    if (code)
+    {
+        for (int i = 0; i < h->codeLen; i++)
+            code[i] = words[i];
+        for (int k = 0; k < 2 * h->wideCount; k++)
+            code[h->codeLen + k] = wide[k];
+        codeLen = h->codeLen;
+        codeWidth = 1;
+        wideCount = h->wideCount;
+        headerStack = h->stack;
+    }
+    else
+        printf("Error: malformed packed program\n");
+    free(words);
+    free(wide);
+    return code;
+}
+/*
+Read the object file: a packed program (pm0pack.h), or optional '#' header
+lines then op L M triples. Sizes the address space (exactly from the
+header with --exact-stack) and loads the code at its top. Returns 0 if
+the program cannot fit.
+*/
+int loadProgram(FILE *in, int memoryCells, int exactStack)
+{
+    char line[128];
+    int c;
+    int *code;
+    // Packed programs start with their magic; anything else is text
+    pm0pack_header packed;
+    if (fread(&packed, sizeof(packed), 1, in) == 1 && memcmp(packed.magic, PM0PACK_MAGIC, sizeof(packed.magic)) == 0)
+    {
+        code = readPacked(in, &packed);
+        if (!code)
+            return 0;
+    }
+    else
+    {
+        rewind(in);
+        // Header lines come first
+        while ((c = fgetc(in)) != EOF)
+        {
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                continue;
+            if (c != '#')
+            {
+                ungetc(c, in);
+                break;
+            }
+            if (!fgets(line, sizeof(line), in))
+                break;
+            sscanf(line, " stack %d", &headerStack);
+        }
+        // Code triples into a temporary buffer until the size is known
+        int cap = 256, op, l, m;
+        code = malloc(cap * sizeof(int));
+        while (code && fscanf(in, "%d %d %d", &op, &l, &m) == 3)
+        {
+            if (3 * codeLen + 3 > cap)
+            {
+                cap *= 2;
+                code = realloc(code, cap * sizeof(int));
+                if (!code)
+                    break;
+            }
+            code[3 * codeLen] = op;
+            code[3 * codeLen + 1] = l;
+            code[3 * codeLen + 2] = m;
+            codeLen++;
+        }
+        if (!code)
+        {
+            printf("Error: out of memory\n");
+            return 0;
+        }
+    }
+    codeCells = codeWidth * codeLen + 2 * wideCount;
+    // Refuse programs whose declared stack does not fit the memory budget
+    if (headerStack >= 0 && codeCells + headerStack > memoryCells)
+    {
+        printf("Error: program needs %d cells but the address space has %d\n", codeCells + headerStack, memoryCells);
+        return 0;
+    }
+    if (codeCells > memoryCells)
+    {
+        printf("Error: program does not fit in the address space\n");
+        return 0;
+    }
+    PAS_SIZE = (exactStack && headerStack >= 0) ? codeCells + headerStack : memoryCells;
+    // Initialize the pas[] values to 0
+    pas = calloc(PAS_SIZE, sizeof(int));
+    if (!pas)
+    {
+        printf("Error: out of memory\n");
+        return 0;
+    }
+    // Load code into PAS from the highest address downward
+    for (int i = 0; i < codeCells; i++)
+        pas[PAS_SIZE - 1 - i] = code[i];
+    free(code);
+    return 1;
+}
+// Helper: add a group's instructions since its last settle to each of its lanes
+void laneSettle(LaneGroup *g, long long *count)
+{
+    for (int j = 0; j < g->count; j++)
+        laneSteps[g->lanes[j]] += *count;
+    *count = 0;
+}
+// Helper: end the lanes of g marked in laneMark with message why (NULL: halted)
+void laneDrop(LaneGroup *g, const char *why)
+{
+    int kept = 0;
+    for (int j = 0; j < g->count; j++)
+    {
+        int k = g->lanes[j];
+        if (laneMark[k])
+        {
+            laneMark[k] = 0;
+            laneOut[k].end = why ? strdup(why) : NULL;
+        }
+        else
+            g->lanes[kept++] = k;
+    }
+    g->count = kept;
+}
+// Helper: move the lanes of g marked in laneMark into a new group at the same place
+LaneGroup laneSplit(LaneGroup *g)
+{
+    LaneGroup out = *g;
+    out.lanes = malloc((size_t)g->count * sizeof(int));
+    out.count = 0;
+    int kept = 0;
+    for (int j = 0; j < g->count; j++)
+    {
+        int k = g->lanes[j];
+        if (laneMark[k])
+        {
+            laneMark[k] = 0;
+            out.lanes[out.count++] = k;
+        }
+        else
+            g->lanes[kept++] = k;
+    }
+    g->count = kept;
+    return out;
+}
+// Helper: park a group, merging it into a waiting group at the same place
+void laneWait(LaneGroup g)
+{
+    if (g.count == 0)
+    {
+        free(g.lanes);
+        return;
+    }
+    for (int w = 0; w < laneWaitingCount; w++)
+    {
+        LaneGroup *o = &laneWaiting[w];
+        if (o->pc != g.pc || o->bp != g.bp || o->sp != g.sp)
+            continue;
+        // Same code address and frame: the lanes run on together, still in lane order
+        int *both = malloc((size_t)(o->count + g.count) * sizeof(int));
+        int i = 0, j = 0, n = 0;
+        while (i < o->count || j < g.count)
+            both[n++] = (j == g.count || (i < o->count && o->lanes[i] < g.lanes[j])) ? o->lanes[i++] : g.lanes[j++];
+        free(o->lanes);
+        free(g.lanes);
+        o->lanes = both;
+        o->count = n;
+        return;
+    }
+    if (laneWaitingCount == laneWaitingCap)
+    {
+        laneWaitingCap = laneWaitingCap ? 2 * laneWaitingCap : 16;
+        laneWaiting = realloc(laneWaiting, (size_t)laneWaitingCap * sizeof(LaneGroup));
+    }
+    laneWaiting[laneWaitingCount++] = g;
+}
+// Helper: 1 if a group at pc should stop for a waiting one: one is at the
+// same place (they merge), or one is behind it in the code
+int laneShouldWait(int pc, int bp, int sp)
+{
+    for (int w = 0; w < laneWaitingCount; w++)
+        if (laneWaiting[w].pc > pc || (laneWaiting[w].pc == pc && laneWaiting[w].bp == bp && laneWaiting[w].sp == sp))
+            return 1;
+    return 0;
+}
+// Lock-step interpreter (--lanes): runs the waiting groups until every lane
+// has ended. Control (PC, BP, SP, links) is the same for all lanes of a
+// group; only the cells differ. The group furthest back in the code runs
+// first, so groups that split at a JPC meet again where their paths join.
+ALWAYS_INLINE void runLanesWidth(const int width)
+{
+    const int *code = pas;
+    int *cells = laneCells;
+    const size_t stride = (size_t)laneCount;
+    while (laneWaitingCount > 0)
+    {
+        // Resume the group with the highest code address (the earliest instruction)
+        int best = 0;
+        for (int w = 1; w < laneWaitingCount; w++)
+            if (laneWaiting[w].pc > laneWaiting[best].pc)
+                best = w;
+        LaneGroup g = laneWaiting[best];
+        laneWaiting[best] = laneWaiting[--laneWaitingCount];
+        int pc = g.pc, bp = g.bp, sp = g.sp;
+        long long count = 0, budget = LLONG_MAX;
+        for (int j = 0; maxSteps > 0 && j < g.count; j++)
+            if (maxSteps - laneSteps[g.lanes[j]] < budget)
+                budget = maxSteps - laneSteps[g.lanes[j]];
+        while (g.count > 0)
+        {
+            if (laneWaitingCount > 0 && laneJoin[pc] && laneShouldWait(pc, bp, sp))
+                break;
+            const int n = g.count, lo = g.lanes[0], dense = (g.lanes[n - 1] - lo + 1 == n);
+            const int *lanes = g.lanes;
+#define CELL(a) (cells + (size_t)(a) * stride)
+#define FOR_LANES(...)                               \
+    do                                               \
+    {                                                \
+        if (dense)                                   \
+            for (int k = lo; k < lo + n; k++)        \
+            {                                        \
+                __VA_ARGS__;                         \
+            }                                        \
+        else                                         \
+            for (int j = 0; j < n; j++)              \
+            {                                        \
+                int k = lanes[j];                    \
+                __VA_ARGS__;                         \
+            }                                        \
+    } while (0)
+            int at = pc;
+            count++;
+            int op, L, m;
+            if (width == 1)
+            {
+                int w = code[at];
+                op = pm0pack_op(w);
+                L = pm0pack_l(w);
+                m = pm0pack_m(w);
+                pc = at - 1;
+            }
+            else
+            {
+                op = code[at];
+                L = code[at - 1];
+                m = code[at - 2];
+                pc = at - 3;
+            }
+        dispatch:
+            switch (op)
+            {
+            case 0: // escaped packed instruction
+            {
+                int k = PAS_SIZE - 1 - codeLen - 2 * m;
+                op = L;
+                L = code[k];
+                m = code[k - 1];
+                goto dispatch;
+            }
+            case 1: // LIT
+            {
+                int *d = CELL(--sp);
+                FOR_LANES(d[k] = m);
+                break;
+            }
+            case 2: // OPR
+            {
+                int *a = CELL(sp), *b = CELL(sp + 1);
+                switch (m)
+                {
+                case 0:
+                    sp = bp + 1;
+                    bp = CELL(sp - 2)[lo];
+                    pc = CELL(sp - 3)[lo];
+                    break;
+                case 1: FOR_LANES(b[k] = b[k] + a[k]); sp++; break;
+                case 2: FOR_LANES(b[k] = b[k] - a[k]); sp++; break;
+                case 3: FOR_LANES(b[k] = b[k] * a[k]); sp++; break;
+                case 4:
+                {
+                    // A lane that would trap ends alone instead of stopping the others
+                    int bad = 0;
+                    FOR_LANES(if (a[k] == 0 || (a[k] == -1 && b[k] == INT_MIN)) laneMark[k] = 1, bad++);
+                    if (bad)
+                    {
+                        char why[64];
+                        snprintf(why, sizeof(why), "Error: division by zero%s", sourceAt(at));
+                        count--; // the others run it again
+                        laneSettle(&g, &count);
+                        laneDrop(&g, why);
+                        pc = at;
+                        continue;
+                    }
+                    FOR_LANES(b[k] = b[k] / a[k]);
+                    sp++;
+                    break;
+                }
+                case 5: FOR_LANES(b[k] = (b[k] == a[k])); sp++; break;
+                case 6: FOR_LANES(b[k] = (b[k] != a[k])); sp++; break;
+                case 7: FOR_LANES(b[k] = (b[k] < a[k])); sp++; break;
+                case 8: FOR_LANES(b[k] = (b[k] <= a[k])); sp++; break;
+                case 9: FOR_LANES(b[k] = (b[k] > a[k])); sp++; break;
+                case 10: FOR_LANES(b[k] = (b[k] >= a[k])); sp++; break;
+                case 11: FOR_LANES(a[k] = (a[k] % 2 == 0)); break;
+                }
+                break;
+            }
+            case 3: // LOD
+            {
+                int from = bp;
+                for (int l = L; l > 0; l--)
+                    from = CELL(from)[lo];
+                const int *src = CELL(from - m);
+                int *d = CELL(--sp);
+                FOR_LANES(d[k] = src[k]);
+                break;
+            }
+            case 4: // STO
+            {
+                int to = bp;
+                for (int l = L; l > 0; l--)
+                    to = CELL(to)[lo];
+                int *d = CELL(to - m);
+                const int *src = CELL(sp++);
+                FOR_LANES(d[k] = src[k]);
+                break;
+            }
+            case 5: // CAL
+            case 10: // TCL
+            {
+                if ((op == 5 ? sp : bp + 1) - callNeed[at] < 0)
+                {
+                    char why[64];
+                    snprintf(why, sizeof(why), "Error: stack overflow%s", sourceAt(at));
+                    laneSettle(&g, &count);
+                    for (int j = 0; j < g.count; j++)
+                        laneMark[g.lanes[j]] = 1;
+                    laneDrop(&g, why);
+                    break;
+                }
+                int link = bp;
+                for (int l = L; l > 0; l--)
+                    link = CELL(link)[lo];
+                if (op == 5)
+                {
+                    int *s1 = CELL(sp - 1), *s2 = CELL(sp - 2), *s3 = CELL(sp - 3), ret = pc, dyn = bp;
+                    FOR_LANES(s1[k] = link; s2[k] = dyn; s3[k] = ret);
+                    bp = sp - 1;
+                }
+                else
+                {
+                    int *s1 = CELL(bp);
+                    FOR_LANES(s1[k] = link);
+                    sp = bp + 1;
+                }
+                pc = (PAS_SIZE - 1) - m;
+                if (width == 1 ? (code[pc] & 0xFF) == 6 : code[pc] == 6)
+                {
+                    count++;
+                    sp -= (width == 1) ? pm0pack_m(code[pc]) : code[pc - 2];
+                    pc -= width;
+                }
+                goto poll;
+            }
+            case 6: // INC
+                sp -= m;
+                break;
+            case 7: // JMP
+                pc = (PAS_SIZE - 1) - m;
+                if (pc >= at)
+                    goto poll;
+                break;
+            case 8: // JPC
+            {
+                const int *c = CELL(sp++);
+                int zeros = 0;
+                FOR_LANES(zeros += (c[k] == 0));
+                if (zeros == 0)
+                    break;
+                if (zeros < n)
+                {
+                    // Diverged: the lanes that jump go on as a group of their own
+                    FOR_LANES(laneMark[k] = (c[k] == 0));
+                    laneSettle(&g, &count);
+                    LaneGroup taken = laneSplit(&g);
+                    taken.pc = (PAS_SIZE - 1) - m, taken.bp = bp, taken.sp = sp;
+                    laneWait(taken);
+                    break;
+                }
+                pc = (PAS_SIZE - 1) - m;
+                if (pc >= at)
+                    goto poll;
+                break;
+            }
+            case 9: // SYS
+                if (m == 1)
+                {
+                    const int *v = CELL(sp++);
+                    FOR_LANES(
+                        LaneOut *o = &laneOut[k];
+                        if (o->n == o->cap && !(o->vals = realloc(o->vals, (size_t)(o->cap = o->cap ? 2 * o->cap : 16) * sizeof(int))))
+                        {
+                            printf("Error: out of memory\n");
+                            exit(1);
+                        }
+                        o->vals[o->n++] = v[k]);
+                }
+                else if (m == 2)
+                {
+                    int *d = CELL(--sp), missing = 0;
+                    FOR_LANES(
+                        if (laneInPos[k] < laneInCount[k])
+                            d[k] = laneIn[laneInStart[k] + laneInPos[k]++];
+                        else
+                            laneMark[k] = 1, missing++);
+                    if (missing)
+                    {
+                        char why[64];
+                        snprintf(why, sizeof(why), "Error: invalid input%s", sourceAt(at));
+                        laneSettle(&g, &count);
+                        laneDrop(&g, why);
+                    }
+                }
+                else
+                {
+                    laneSettle(&g, &count);
+                    for (int j = 0; j < g.count; j++)
+                        laneMark[g.lanes[j]] = 1;
+                    laneDrop(&g, NULL);
+                }
+                break;
+            }
+            continue;
+        // Calls and backward jumps: the step limit is checked here, as in runFast()
+        poll:
+            if (count >= budget)
+            {
+                laneSettle(&g, &count);
+                budget = LLONG_MAX;
+                for (int j = 0; j < g.count; j++)
+                {
+                    int k = g.lanes[j];
+                    if (laneSteps[k] >= maxSteps)
+                        laneMark[k] = 1;
+                    else if (maxSteps - laneSteps[k] < budget)
+                        budget = maxSteps - laneSteps[k];
+                }
+                laneDrop(&g, "Stopped: step limit reached");
+            }
+#undef FOR_LANES
+#undef CELL
+        }
+        laneSettle(&g, &count);
+        g.pc = pc, g.bp = bp, g.sp = sp;
+        laneWait(g);
+    }
+}
+/*
+Lanes (--lanes): run one instance of the program per line of path, each
+line holding that instance's SYS 2 input, and print one line per instance
+with its SYS 1 values separated by spaces. An instance that stops early
+ends its line with the message. Returns 0 if every instance halted.
+*/
+int runLanes(const char *path)
+{
+    if (!loadInput(path))
     {
-        arb = pas[arb]; // follow static link
-        L--;
+        printf("Error: cannot read %s\n", path);
+        return 1;
     }
-    return arb;
+    // One lane per line; its values up to the first token that is not a number
+    size_t values = 0;
+    for (size_t i = 0; i < inLen; i++)
+        if (inBuf[i] == '\n')
+            laneCount++;
+    if (inLen > 0 && inBuf[inLen - 1] != '\n')
+        laneCount++;
+    for (size_t i = 0; i < inLen; i++)
+        if (inBuf[i] >= '0' && inBuf[i] <= '9' && (i == 0 || inBuf[i - 1] < '0' || inBuf[i - 1] > '9'))
+            values++;
+    size_t cellCount = (size_t)(STACK_TOP + 1) * (size_t)laneCount;
+    laneCells = calloc(cellCount ? cellCount : 1, sizeof(int));
+    laneSteps = calloc((size_t)laneCount + 1, sizeof(long long));
+    laneIn = malloc((values + 1) * sizeof(int));
+    laneInStart = malloc(((size_t)laneCount + 1) * sizeof(int));
+    laneInCount = calloc((size_t)laneCount + 1, sizeof(int));
+    laneInPos = calloc((size_t)laneCount + 1, sizeof(int));
+    laneOut = calloc((size_t)laneCount + 1, sizeof(LaneOut));
+    laneMark = calloc((size_t)laneCount + 1, 1);
+    laneJoin = calloc(PAS_SIZE, 1);
+    LaneGroup all = {PAS_SIZE - 1, STACK_TOP, STACK_TOP + 1, malloc(((size_t)laneCount + 1) * sizeof(int)), laneCount};
+    if (laneCount == 0 || !laneCells || !laneSteps || !laneIn || !laneInStart || !laneInCount || !laneInPos ||
+        !laneOut || !laneMark || !laneJoin || !all.lanes)
+    {
+        printf(laneCount ? "Error: out of memory\n" : "Error: %s has no lines\n", path);
+        return 1;
+    }
+    size_t line = 0, n = 0, end = 0;
+    for (int k = 0; k < laneCount; k++, line = end + 1)
+    {
+        for (end = line; end < inLen && inBuf[end] != '\n'; end++)
+            ;
+        laneInStart[k] = (int)n;
+        // readInt() over just this line
+        const char *saveBuf = inBuf;
+        size_t saveLen = inLen;
+        inBuf = saveBuf + line;
+        inLen = end - line;
+        inPos = 0;
+        int value;
+        while (readInt(&value))
+            laneIn[n++] = value;
+        laneInCount[k] = (int)n - laneInStart[k];
+        inBuf = saveBuf;
+        inLen = saveLen;
+        all.lanes[k] = k;
+    }
+    // Join points: jump targets and the instructions calls return to
+    for (int i = 0; i < codeLen; i++)
+    {
+        int op, L, M, addr = PAS_SIZE - 1 - codeWidth * i;
+        fetch(addr, &op, &L, &M);
+        if (op == 7 || op == 8)
+            laneJoin[(PAS_SIZE - 1) - M] = 1;
+        if (op == 5 && i + 1 < codeLen)
+            laneJoin[addr - codeWidth] = 1;
+    }
+    laneWait(all);
+    if (codeWidth == 1)
+        runLanesWidth(1);
+    else
+        runLanesWidth(3);
+    // One line per lane
+    int status = 0;
+    for (int k = 0; k < laneCount; k++)
+    {
+        LaneOut *o = &laneOut[k];
+        for (int j = 0; j < o->n; j++)
+            printf(j ? " %d" : "%d", o->vals[j]);
+        if (o->end)
+        {
+            printf(o->n ? " %s" : "%s", o->end);
+            status = 1;
+        }
+        putchar('\n');
+    }
+    return status;
 }
-// Helper: print trace of stack with AR separator
-void printStack()
+// Helper: put a trap over the instruction at code address at (--debug)
+void debugPatch(int at)
 {
-    // walks from highest stack address to lowest address
-    for (int i = STACK_TOP; i >= SP; i--)
+    for (int k = 0; k < patchCount; k++)
+        if (patchAt[k] == at)
+            return;
+    patchAt[patchCount] = at;
+    patchCell[2 * patchCount] = pas[at];
+    patchCell[2 * patchCount + 1] = pas[at - 2];
+    patchCount++;
+    if (codeWidth == 1)
+        pas[at] = pm0pack_word(PM0PACK_ESCAPE, 0, TRAP_M);
+    else
+        pas[at] = 0, pas[at - 2] = TRAP_M;
+}
+// Helper: take every trap out again, so the stopped program reads as loaded
+void debugUnpatch()
+{
+    while (patchCount > 0)
     {
-        // put '|' before AR (after first cycle)
-        if (i == BP && i != SP && BP != STACK_TOP)
-            printf("| ");
-        printf("%2d ", pas[i]);
+        patchCount--;
+        pas[patchAt[patchCount]] = patchCell[2 * patchCount];
+        if (codeWidth == 3)
+            pas[patchAt[patchCount] - 2] = patchCell[2 * patchCount + 1];
+    }
+}
+// Helper: code address of instruction i, and the reverse; -1 outside the code
+int debugAddress(int i)
+{
+    return (i >= 0 && i < codeLen) ? PAS_SIZE - 1 - codeWidth * i : -1;
+}
+int debugInstruction(int at)
+{
+    int i = (PAS_SIZE - 1 - at) / codeWidth;
+    return (at <= PAS_SIZE - 1 && (PAS_SIZE - 1 - at) % codeWidth == 0 && i < codeLen) ? i : -1;
+}
+// Helper: run the patched program in the fast interpreter, then take the traps
+// out again. The trap that stopped it did not run, so it is not counted.
+int debugRun()
+{
+    trapped = 0;
+    int status = runFast();
+    debugUnpatch();
+    if (trapped)
+        steps--;
+    return status;
+}
+// Helper: run the instruction at PC and stop after it. It has one successor,
+// known from the registers, which gets the only trap. Returns RUN_BREAK, or the
+// exit status if the program ended.
+int debugStep()
+{
+    int op, L, M, next = PC - codeWidth;
+    fetch(PC, &op, &L, &M);
+    if (op == 9 && M == 3)
+        next = -1; // halts
+    else if (op == 2 && M == 0)
+        next = pas[BP - 2]; // return address
+    else if (op == 5 || op == 7 || op == 10 || (op == 8 && pas[SP] == 0))
+        next = (PAS_SIZE - 1) - M;
+    if (next == PC && op != 5 && op != 10)
+    {
+        // A jump or return to itself: the trap would stop it before it runs
+        if (op == 8)
+            SP++;
+        else if (op == 2)
+        {
+            SP = BP + 1;
+            BP = pas[SP - 2];
+        }
+        steps++;
+        return RUN_BREAK;
+    }
+    if (debugInstruction(next) >= 0)
+        debugPatch(next);
+    return debugRun();
+}
+// Helper: run until a breakpoint, SIGINT or the end of the program
+int debugContinue()
+{
+    if (breakAt[debugInstruction(PC)])
+    {
+        // Step off the breakpoint first; its trap would stop the run at once
+        int status = debugStep();
+        if (status != RUN_BREAK || breakAt[debugInstruction(PC)])
+            return status;
+    }
+    for (int i = 0; i < codeLen; i++)
+        if (breakAt[i])
+            debugPatch(debugAddress(i));
+    debugBreak = 0;
+    return debugRun();
+}
+// Helper: say where the program stopped
+void debugWhere(const char *why)
+{
+    int op, L, M;
+    fetch(PC, &op, &L, &M);
+    printf("%s at instruction %d%s: %s %d %d, PC %d, BP %d, SP %d\n", why, debugInstruction(PC), sourceAt(PC),
+           operationNames[op], L, M, PC, BP, SP);
+}
+// Helper: show the activation record L static levels up, found with base().
+// Its cells run down to the frame it called (the one whose dynamic link is
+// its base), or to SP for the current frame.
+void debugFrame(int L)
+{
+    int e = procOf[debugInstruction(PC)];
+    if (L < 0 || L > staticDepth[e])
+    {
+        printf("No frame %d levels up (the procedure is at depth %d)\n", L, staticDepth[e]);
+        return;
+    }
+    int b = base(BP, L), low = SP;
+    for (int x = BP; x != b && x != STACK_TOP; x = pas[x - 1])
+        if (pas[x - 1] == b)
+        {
+            low = x + 1;
+            break;
+        }
+    if (b == STACK_TOP)
+        printf("Frame %d at base %d (main)\n", L, b);
+    else
+        printf("Frame %d at base %d: static link %d, dynamic link %d, return to instruction %d%s\n", L, b, pas[b],
+               pas[b - 1], debugInstruction(pas[b - 2]), sourceAt(pas[b - 2]));
+    if (b - 3 < low)
+        printf("  no cells below the links\n");
+    else
+    {
+        printf("  offset:value");
+        for (int a = b - 3; a >= low; a--)
+            printf(" %d:%d", b - a, pas[a]);
+        printf("\n");
+    }
+}
+/*
+Debugger (--debug): read commands from stdin and run the program between
+stops in the fast interpreter. Breakpoints are traps patched into the code
+only while it runs, so a stopped program shows its code as loaded. Returns
+the program's exit status, or RUN_BREAK if quit while it was stopped.
+*/
+int runDebugger()
+{
+    breakAt = calloc(codeLen + 1, 1);
+    patchAt = malloc((codeLen + 1) * sizeof(int));
+    patchCell = malloc(2 * (codeLen + 1) * sizeof(int));
+    if (!breakAt || !patchAt || !patchCell)
+    {
+        printf("Error: out of memory\n");
+        return 1;
+    }
+    debugWhere("Stopped");
+    char line[256];
+    for (;;)
+    {
+        printf("(pm0db) ");
+        fflush(stdout);
+        if (!fgets(line, sizeof(line), stdin))
+        {
+            printf("\n");
+            return RUN_BREAK;
+        }
+        char cmd[16];
+        int used = 0, n = 0, status = RUN_BREAK;
+        if (sscanf(line, " %15s %n", cmd, &used) < 1)
+            continue;
+        const char *arg = line + used;
+        int hasArg = sscanf(arg, "%d", &n) == 1;
+        if (strcmp(cmd, "break") == 0 || strcmp(cmd, "b") == 0)
+        {
+            if (sscanf(arg, "line %d", &n) == 1)
+            {
+                int i = 0;
+                while (i < codeLen && !(lineOf && lineOf[i] == n && procOf[i] != -1))
+                    i++;
+                if (i == codeLen)
+                {
+                    printf("No code for line %d%s\n", n, lineOf ? "" : " (no line table)");
+                    continue;
+                }
+                n = i;
+            }
+            else if (!hasArg)
+            {
+                for (int i = 0; i < codeLen; i++)
+                    if (breakAt[i])
+                        printf("Breakpoint at instruction %d%s\n", i, sourceAt(debugAddress(i)));
+                continue;
+            }
+            if (n < 0 || n >= codeLen || procOf[n] == -1)
+                printf("Instruction %d is not reachable code\n", n);
+            else
+            {
+                breakAt[n] = 1;
+                printf("Breakpoint at instruction %d%s\n", n, sourceAt(debugAddress(n)));
+            }
+            continue;
+        }
+        else if (strcmp(cmd, "delete") == 0 || strcmp(cmd, "d") == 0)
+        {
+            if (!hasArg)
+                printf("Usage: delete n\n");
+            else if (n >= 0 && n < codeLen && breakAt[n])
+                breakAt[n] = 0;
+            else
+                printf("No breakpoint at instruction %d\n", n);
+            continue;
+        }
+        else if (strcmp(cmd, "step") == 0 || strcmp(cmd, "s") == 0)
+        {
+            for (int k = hasArg ? n : 1; k > 0 && status == RUN_BREAK; k--)
+                status = debugStep();
+        }
+        else if (strcmp(cmd, "continue") == 0 || strcmp(cmd, "c") == 0)
+            status = debugContinue();
+        else if (strcmp(cmd, "frame") == 0 || strcmp(cmd, "f") == 0)
+        {
+            debugFrame(hasArg ? n : 0);
+            continue;
+        }
+        else if (strcmp(cmd, "stack") == 0)
+        {
+            printf("PC %d BP %d SP %d stack: ", PC, BP, SP);
+            printStack();
+            continue;
+        }
+        else if (strcmp(cmd, "quit") == 0 || strcmp(cmd, "q") == 0)
+            return RUN_BREAK;
+        else
+        {
+            printf("Commands: break [n | line n], delete n, step [n], continue, frame [L], stack, quit\n");
+            continue;
+        }
+        flushOutput();
+        if (status != RUN_BREAK)
+        {
+            if (status == 0)
+                printf("Program halted\n");
+            return status;
+        }
+        debugWhere(breakAt[debugInstruction(PC)] ? "Breakpoint" : "Stopped");
     }
-    printf("\n");
 }
 int main(int argc, char *argv[])
 {
     // Handle the Command Line
-    if (argc != 2)
+    const char *elfPath = NULL;
+    const char *inputPath = NULL;
+    const char *restorePath = NULL;
+    const char *debugPath = NULL;
+    int memoryCells = MAX_PAS, exactStack = 0;
+    int profiling = 0;
+    const char *tracePath = NULL, *sessionPath = NULL, *lanesPath = NULL, *replayPath = NULL;
+    int badArgs = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--batch") == 0)
+            batchMode = 1;
+        else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+            inputPath = argv[++i];
+        else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc)
+            memoryCells = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--exact-stack") == 0)
+            exactStack = 1;
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+            checkpointPath = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc)
+            checkpointEvery = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc)
+            restorePath = argv[++i];
+        else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc)
+            maxSteps = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+            timeoutSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--debug-info") == 0 && i + 1 < argc)
+            debugPath = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0)
+            profiling = 1;
+        else if (strcmp(argv[i], "--trace-bin") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--debug") == 0)
+            debugging = 1;
+        else if (strcmp(argv[i], "--lanes") == 0 && i + 1 < argc)
+            lanesPath = argv[++i];
+        else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc)
+            sessionPath = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            sessionThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc)
+            quantum = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--metrics-fd") == 0 && i + 1 < argc)
+        {
+            char *end;
+            long fd = strtol(argv[++i], &end, 10);
+            if (*end || end == argv[i] || fd < 0 || fd > INT_MAX || fcntl((int)fd, F_GETFD) < 0)
+                badArgs = 1;
+            else
+                metricsFd = (int)fd;
+        }
+        else if (!elfPath && argv[i][0] != '-')
+            elfPath = argv[i];
+        else
+            badArgs = 1;
+    }
+    if (badArgs || (!elfPath == !restorePath) || memoryCells <= 0 || checkpointEvery < 0 || maxSteps < 0 || timeoutSeconds < 0 ||
+        (checkpointEvery > 0 && !checkpointPath))
     {
         printf("Error: expected 1 argument (input file)\n");
         return 1;
     }
-    // open the file passed on the command line
-    FILE *in = fopen(argv[1], "r");
-    if (!in)
+    if (sessionPath && (batchMode || inputPath || checkpointPath || restorePath || timeoutSeconds > 0 ||
+                        profiling || tracePath || metricsFd >= 0 || recordPath || replayPath ||
+                        sessionThreads < 1 || sessionThreads > 256 || quantum < 1))
     {
-        printf("Error: cannot open input file\n");
+        printf("Error: --sessions takes only --threads, --quantum, --max-steps, --memory, --exact-stack and --debug-info\n");
         return 1;
     }
-    // Initialize the pas[] values to 0
-    for (int i = 0; i < MAX_PAS; i++)
+    if (lanesPath && (batchMode || inputPath || checkpointPath || restorePath || timeoutSeconds > 0 ||
+                      profiling || tracePath || metricsFd >= 0 || recordPath || replayPath || sessionPath))
+    {
+        printf("Error: --lanes takes only --max-steps, --memory, --exact-stack and --debug-info\n");
+        return 1;
+    }
+    if (debugging && (checkpointPath || profiling || tracePath || metricsFd >= 0 || sessionPath || lanesPath))
     {
-        pas[i] = 0;
+        printf("Error: --debug cannot take --checkpoint, --profile, --trace-bin, --metrics-fd, --sessions or --lanes\n");
+        return 1;
     }
-    // Load code into PAS from address 499 downward
-    int op, l, m;
-    int addr = MAX_PAS - 1;
-    while (fscanf(in, "%d %d %d", &op, &l, &m) == 3)
+    if (replayPath && (inputPath || recordPath || tracePath))
     {
-        pas[addr--] = op;
-        pas[addr--] = l;
-        pas[addr--] = m;
+        printf("Error: --replay runs in batch mode and reads no other input; it cannot take --input, --record or --trace-bin\n");
+        return 1;
     }
-    fclose(in);
-    // Initialize Registers
-    PC = MAX_PAS - 1; // first OP is at 499
-    SP = addr + 1;    // first free cell below code
-    BP = SP - 1;
-    STACK_TOP = SP - 1; // stack initially empty; establish top boundary for printing
+    if (recordPath && restorePath)
+    {
+        printf("Error: --record needs the whole run; it cannot take --restore\n");
+        return 1;
+    }
+    // A replay is a batch run whose input is the log
+    if (replayPath)
+        batchMode = replaying = 1;
+    // The debugger runs the program in the fast interpreter between stops
+    if (debugging)
+        batchMode = 1;
+    if (tracePath && batchMode)
+    {
+        printf("Error: --trace-bin traces the checked interpreter, not --batch\n");
+        return 1;
+    }
+    if (inputPath && !batchMode)
+    {
+        printf("Error: --input requires --batch\n");
+        return 1;
+    }
+    // Batch mode reads its input on the first SYS 2. The debugger reads its
+    // commands from stdin, so its program reads only --input (or a replay).
+    if (debugging && !inputPath)
+        inDone = 1;
+    if (batchMode && !replaying && !inDone && !openInput(inputPath))
+    {
+        fprintf(stderr, "Error: cannot read program input\n");
+        return 1;
+    }
+    if (restorePath)
+    {
+        // Resume a snapshot: address space, registers and input position
+        if (!restoreSnapshot(restorePath))
+            return 1;
+        // Interactive input: skip the values the original run already read
+        for (long long i = 0; !batchMode && i < inputCount; i++)
+        {
+            int skipped;
+            if (scanf("%d", &skipped) != 1)
+                break;
+        }
+    }
+    else
+    {
+        // open the file passed on the command line
+        FILE *in = fopen(elfPath, "r");
+        if (!in)
+        {
+            printf("Error: cannot open input file\n");
+            return 1;
+        }
+        int loaded = loadProgram(in, memoryCells, exactStack);
+        fclose(in);
+        if (!loaded)
+            return 1;
+        // Initialize Registers
+        PC = PAS_SIZE - 1; // first OP is at the top (499 by default)
+        SP = PAS_SIZE - codeCells; // first free cell below code
+        BP = SP - 1;
+        STACK_TOP = SP - 1; // stack initially empty; establish top boundary for printing
+    }
+    // Line table: named explicitly, or elf.dbg beside elf.txt (or elf.bin)
+    if (debugPath)
+    {
+        if (!loadDebugInfo(debugPath, 1))
+            return 1;
+    }
+    else if (elfPath)
+    {
+        char dbg[4096];
+        size_t n = strlen(elfPath);
+        if (n >= 4 && (strcmp(elfPath + n - 4, ".txt") == 0 || strcmp(elfPath + n - 4, ".bin") == 0) && n < sizeof(dbg))
+        {
+            snprintf(dbg, sizeof(dbg), "%.*s.dbg", (int)(n - 4), elfPath);
+            if (!loadDebugInfo(dbg, 0))
+                return 1;
+        }
+    }
+    // Reject unsafe programs before running anything
+    if (!verifyProgram())
+        return 1;
+    // Sessions share the verified code; each runs in its own stack segment
+    if (sessionPath)
+        return runSessions(sessionPath);
+    // Lanes run one instance per input line in lock-step
+    if (lanesPath)
+        return runLanes(lanesPath);
+    // A replay resumes from a snapshot at the input the snapshot had reached
+    if (replayPath)
+    {
+        if (!loadInputLog(replayPath))
+            return 1;
+        replayPos = inputCount < inputLogLen ? inputCount : inputLogLen;
+    }
+    if (profiling)
+    {
+        profile = calloc(PAS_SIZE, sizeof(long long));
+        if (!profile)
+        {
+            printf("Error: out of memory\n");
+            return 1;
+        }
+        atexit(reportProfile);
+    }
+    // Checkpoints on request (SIGUSR1), on preemption (SIGTERM) and by interval
+    if (checkpointPath)
+    {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = onSignal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGUSR1, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+        if (checkpointEvery > 0)
+            nextCheckpoint = steps + checkpointEvery;
+    }
+    // Wall-clock limit: SIGALRM sets a flag the next safepoint acts on
+    if (timeoutSeconds > 0)
+    {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = onSignal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGALRM, &sa, NULL);
+        struct itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        timer.it_value.tv_sec = (long)timeoutSeconds;
+        timer.it_value.tv_usec = (long)((timeoutSeconds - (long)timeoutSeconds) * 1e6);
+        if (timer.it_value.tv_sec == 0 && timer.it_value.tv_usec == 0)
+            timer.it_value.tv_usec = 1;
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+    // Metrics: SIGINT, and SIGTERM when it does not mean preemption, stop the
+    // run at the next safepoint so the record is still written
+    if (metricsFd >= 0)
+    {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = onSignal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, NULL);
+        if (!checkpointPath)
+            sigaction(SIGTERM, &sa, NULL);
+        startMetrics();
+    }
+    // Debugger: SIGINT stops the running program at the next safepoint
+    if (debugging)
+    {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = onSignal;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, NULL);
+        scheduleSafepoint();
+        // Quitting leaves the program stopped, which is not an error
+        int status = finishRun(runDebugger());
+        flushOutput();
+        return status == RUN_BREAK ? 0 : status;
+    }
+    scheduleSafepoint();
+    // Batch mode runs the verified program in the fast interpreter
+    if (batchMode)
+    {
+        int status = runFast();
+        flushOutput();
+        return finishRun(status);
+    }
+    if (tracePath)
+    {
+        if (!openTrace(tracePath))
+            return 1;
+    }
+    else
+    {
         // Print header
         printf(" L M PC BP SP stack\n");
-    // Print initial state
-    printf("Initial values : %d %d %d\n", PC, BP, SP);
+        // Print initial state
+        printf("Initial values : %d %d %d\n", PC, BP, SP);
+    }
     // Fetch-Execute Loop
     int halt = 0;
     while (!halt)
     {
+        int at = PC, badInput = 0;
+        steps++;
+        if (profile)
+            profile[at]++;
         // Fetch
-        IR.OP = pas[PC];
-        IR.L = pas[PC - 1];
-        IR.M = pas[PC - 2];
-        PC = PC - 3;
+        fetch(PC, &IR.OP, &IR.L, &IR.M);
+        PC = PC - codeWidth;
         // Execute for Operations of PM/0 (1-9)
         switch (IR.OP)
         {
@@ -171,6 +3030,14 @@ int main(int argc, char *argv[])
                 break;
             // DIV (M = 4)
             case 4:
+                // Dividing by zero (or INT_MIN by -1) would trap
+                if (pas[SP] == 0 || (pas[SP] == -1 && pas[SP + 1] == INT_MIN))
+                {
+                    printf("Error: division by zero%s\n", sourceAt(at));
+                    halt = 1;
+                    runError = 1;
+                    break;
+                }
                 pas[SP + 1] = pas[SP + 1] / pas[SP];
                 SP = SP + 1;
                 break;
@@ -251,18 +3118,54 @@ int main(int argc, char *argv[])
             bp <- sp - 1
             pc <- mapped address of M
             */
-            pas[SP - 1] = base(BP, IR.L); // static link
+            // Recursion depth is not static: the callee's frame must fit
+            if (SP - callNeed[at] < 0)
+            {
+                printf("Error: stack overflow%s\n", sourceAt(at));
+                halt = 1;
+                runError = 1;
+                break;
+            }
+            pas[SP - 1] = (IR.L == 0) ? BP : base(BP, IR.L); // static link
             pas[SP - 2] = BP;             // dynamic link
             pas[SP - 3] = PC;             // return address
             BP = SP - 1;
-            PC = (MAX_PAS - 1) - IR.M; // map IR.M (word offset) to op address 
+            PC = (PAS_SIZE - 1) - IR.M; // map IR.M (word offset) to op address 
         break;
+        // TCL (10)
+        case 10:
+            /*
+            Tail call: reuse the current AR for the callee.
+            Only emitted with L >= 1, so the callee never needs this frame.
+            pas[bp] <- base(bp,L) (new static link)
+            dynamic link and return address are kept
+            sp <- bp + 1 (drop locals)
+            pc <- mapped address of M
+            */
+            if (BP + 1 - callNeed[at] < 0)
+            {
+                printf("Error: stack overflow%s\n", sourceAt(at));
+                halt = 1;
+                runError = 1;
+                break;
+            }
+            pas[BP] = base(BP, IR.L);
+            SP = BP + 1;
+            PC = (PAS_SIZE - 1) - IR.M;
+            break;
         // INC (6)
         case 6:
             /*
             Allocate M locals on the stack:
             sp <- sp - M
             */
+            if (SP - IR.M < 0)
+            {
+                printf("Error: stack overflow%s\n", sourceAt(at));
+                halt = 1;
+                runError = 1;
+                break;
+            }
             SP = SP - IR.M;
             break;
         // JMP (7)
@@ -271,7 +3174,7 @@ int main(int argc, char *argv[])
             Unconditional jump:
             pc <- mapped address of M
             */
-            PC = (MAX_PAS - 1) - IR.M;
+            PC = (PAS_SIZE - 1) - IR.M;
             break;
         // JPC (8)
         case 8:
@@ -282,7 +3185,7 @@ int main(int argc, char *argv[])
             */
             if (pas[SP] == 0)
             {
-                PC = (MAX_PAS - 1) - IR.M;
+                PC = (PAS_SIZE - 1) - IR.M;
             }
             SP = SP + 1;
             break;
@@ -301,13 +3204,30 @@ int main(int argc, char *argv[])
                 /*
                 Read an integer from stdin and push it
                 */
+                SP = SP - 1;
                 printf("Please Enter an Integer : ");
                 fflush(stdout);
-                SP = SP - 1;
                 if (scanf("%d", &pas[SP]) != 1)
                 {
+                    // The timeout interrupts a read that is still waiting
+                    if ((timedOut || stopRequested) && metricsFd >= 0)
+                        meterStep();
+                    if (timedOut)
+                        return finishRun(stopSummary(EXIT_TIMEOUT, "timeout"));
+                    // as does SIGINT (or SIGTERM without --checkpoint) with --metrics-fd
+                    if (stopRequested && !checkpointPath)
+                        return finishRun(stopSummary(128 + stopRequested, "signal"));
                     printf("Error: invalid input\n");
+                    inputLogFlags |= INPUT_LOG_BAD_END;
                     halt = 1;
+                    badInput = 1;
+                    runError = 1;
+                }
+                else
+                {
+                    inputCount++;
+                    if (recordPath)
+                        recordInput(pas[SP]);
                 }
             }
             else if (IR.M == 3)
@@ -323,57 +3243,76 @@ int main(int argc, char *argv[])
         default:
             printf("Error: invalid opcode %d\n", IR.OP);
             halt = 1;
+            runError = 1;
         }
-        // Print trace after executing instruction
-        const char *mn = operationNames[IR.OP];
-        if (IR.OP == 2)
+        if (metricsFd >= 0)
+            meterStep();
+        // Trace after executing instruction: a binary record, or the text line
+        if (traceBuf)
         {
-            switch (IR.M)
+            if (traceFd >= 0)
+                traceStep(at, badInput ? TRACE_BAD_INPUT : 0);
+        }
+        else
+        {
+            const char *mn = operationNames[IR.OP];
+            if (IR.OP == 2)
             {
-            case 0:
-                mn = "RTN";
-                break;
-            case 1:
-                mn = "ADD";
-                break;
-            case 2:
-                mn = "SUB";
-                break;
-            case 3:
-                mn = "MUL";
-                break;
-            case 4:
-                mn = "DIV";
-                break;
-            case 5:
-                mn = "EQL";
-                break;
-            case 6:
-                mn = "NEQ";
-                break;
-            case 7:
-                mn = "LSS";
-                break;
-            case 8:
-                mn = "LEQ";
-                break;
-            case 9:
-                mn = "GTR";
-                break;
-            case 10:
-                mn = "GEQ";
-                break;
-            case 11:
-                mn = "EVEN";
-                break; // HW4: mnemonic for OPR 11
-            default:
-                mn = "OPR";
-                break;
+                switch (IR.M)
+                {
+                case 0:
+                    mn = "RTN";
+                    break;
+                case 1:
+                    mn = "ADD";
+                    break;
+                case 2:
+                    mn = "SUB";
+                    break;
+                case 3:
+                    mn = "MUL";
+                    break;
+                case 4:
+                    mn = "DIV";
+                    break;
+                case 5:
+                    mn = "EQL";
+                    break;
+                case 6:
+                    mn = "NEQ";
+                    break;
+                case 7:
+                    mn = "LSS";
+                    break;
+                case 8:
+                    mn = "LEQ";
+                    break;
+                case 9:
+                    mn = "GTR";
+                    break;
+                case 10:
+                    mn = "GEQ";
+                    break;
+                case 11:
+                    mn = "EVEN";
+                    break; // HW4: mnemonic for OPR 11
+                default:
+                    mn = "OPR";
+                    break;
+                }
             }
+            // Print each operation with formatting for L, M, PC, BP & SP
+            printf("%-7s %3d %9d %5d %5d %5d ", mn, IR.L, IR.M, PC, BP, SP);
+            printStack();
+        }
+        // Safepoint after calls and backward jumps, as in runFast()
+        if ((IR.OP == 5 || IR.OP == 10 || ((IR.OP == 7 || IR.OP == 8) && PC >= at)) &&
+            (steps >= safepointAt || signalPending) && !halt)
+        {
+            int status = safepoint();
+            if (status)
+                return finishRun(status);
         }
-        // Print each operation with formatting for L, M, PC, BP & SP
-        printf("%-7s %3d %9d %5d %5d %5d ", mn, IR.L, IR.M, PC, BP, SP);
-        printStack();
     }
-    return 0;
+    return finishRun(0);
 }
\ No newline at end of file